@@ -0,0 +1,691 @@
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include <halcyon/archive.hpp>
+#include <halcyon/image.hpp>
+#include <halcyon/video.hpp>
+
+#include <halcyon/utility/strutil.hpp>
+#include <halcyon/utility/thread_pool.hpp>
+#include <halcyon/utility/timer.hpp>
+
+// Halcyon benchmarks.
+// A single benchmark-runner executable, modeled after HalTest.
+// Benchmarks are selected by specifying the appropriate command-line argument.
+
+namespace bench
+{
+    // Run a function a number of times and return the average time of one run, in milliseconds.
+    template <typename F>
+    hal::f64 measure(std::size_t runs, F&& func)
+    {
+        const hal::timer t;
+
+        for (std::size_t i { 0 }; i < runs; ++i)
+            func();
+
+        return t() * 1000.0 / static_cast<hal::f64>(runs);
+    }
+
+    void report(std::string_view name, hal::f64 ms)
+    {
+        std::cout << name << ": " << ms << " ms\n";
+    }
+
+    // A cheap, deterministic position generator.
+    class scatter
+    {
+    public:
+        scatter(hal::pixel::point area)
+            : m_area { area }
+        {
+        }
+
+        hal::coord::point operator()()
+        {
+            return { static_cast<hal::coord_t>(next() % m_area.x), static_cast<hal::coord_t>(next() % m_area.y) };
+        }
+
+    private:
+        std::uint32_t next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return m_state >> 8;
+        }
+
+        hal::pixel::point m_area;
+        std::uint32_t     m_state { 1 };
+    };
+
+    // Sprites drawn one by one via copyer vs. via a sprite batch.
+    int sprite_batch()
+    {
+        constexpr hal::pixel::point size { 1280, 720 };
+        constexpr std::size_t       sprites { 10'000 }, frames { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalBench: Sprite batch", size, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::surface surf { { 16, 16 } };
+        surf.fill(hal::palette::orange);
+
+        const hal::static_texture tex { rnd.make_texture(surf) };
+
+        hal::sprite_batch batch { rnd.make_sprite_batch(tex) };
+        batch.reserve(sprites);
+
+        const auto per_call = [&]()
+        {
+            scatter pos { size };
+
+            for (std::size_t i { 0 }; i < sprites; ++i)
+                rnd.render(tex).to(pos())();
+
+            rnd.present();
+        };
+
+        const auto batched = [&]()
+        {
+            scatter pos { size };
+
+            for (std::size_t i { 0 }; i < sprites; ++i)
+                batch.draw().to(pos())();
+
+            batch.flush();
+            rnd.present();
+        };
+
+        report("copyer", measure(frames, per_call));
+        report("sprite_batch", measure(frames, batched));
+
+        return EXIT_SUCCESS;
+    }
+
+    // Many small images drawn from their own textures vs. from atlas pages.
+    int atlas()
+    {
+        constexpr hal::pixel::point size { 1280, 720 };
+        constexpr std::size_t       images { 300 }, frames { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalBench: Atlas", size, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        std::vector<hal::surface>        surfaces;
+        std::vector<hal::static_texture> textures;
+
+        hal::atlas_builder builder;
+
+        for (std::size_t i { 0 }; i < images; ++i)
+        {
+            hal::surface& s { surfaces.emplace_back(hal::pixel::point { 16 + static_cast<hal::pixel_t>(i % 5) * 8, 16 + static_cast<hal::pixel_t>(i % 7) * 4 }) };
+            s.fill(hal::palette::orange);
+
+            textures.push_back(rnd.make_texture(s));
+            builder.add(s);
+        }
+
+        const hal::timer build_time;
+        const hal::atlas atl { builder(rnd) };
+
+        report("atlas build", build_time() * 1000.0);
+
+        const auto separate = [&]()
+        {
+            scatter pos { size };
+
+            for (const hal::static_texture& tex : textures)
+                rnd.render(tex).to(pos())();
+
+            rnd.present();
+        };
+
+        const auto atlased = [&]()
+        {
+            scatter pos { size };
+
+            for (hal::atlas::id_t i { 0 }; i < atl.size(); ++i)
+                rnd.render(atl.page(atl[i].page)).from(atl[i].area).to(pos())();
+
+            rnd.present();
+        };
+
+        report("separate textures", measure(frames, separate));
+        report("atlas", measure(frames, atlased));
+
+        return EXIT_SUCCESS;
+    }
+
+    // A 1000-character paragraph rasterized every frame vs. drawn from a glyph cache.
+    int glyph_cache()
+    {
+        constexpr hal::pixel::point size { 1280, 720 };
+        constexpr std::size_t       chars { 1000 }, line_length { 80 }, frames { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+        hal::ttf::context  tctx;
+
+        hal::window   wnd { vid.make_window("HalBench: Glyph cache", size, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        const hal::font fnt { tctx.load("assets/m5x7.ttf", 16) };
+
+        std::string paragraph;
+
+        for (std::size_t i { 0 }; i < chars; ++i)
+            paragraph += (i % line_length == line_length - 1) ? '\n' : static_cast<char>('a' + i * 7 % 26);
+
+        hal::glyph_cache cache { rnd };
+
+        const auto rasterized = [&]()
+        {
+            const hal::static_texture tex { rnd.make_texture(fnt.render(paragraph).wrap(0)(hal::font::render_type::blended)) };
+            rnd.render(tex)();
+
+            rnd.present();
+        };
+
+        const auto cached = [&]()
+        {
+            cache.draw(fnt, paragraph).type(hal::font::render_type::blended)();
+
+            rnd.present();
+        };
+
+        report("font_text", measure(frames, rasterized));
+        report("glyph_cache", measure(frames, cached));
+
+        return EXIT_SUCCESS;
+    }
+
+    // Inverting a surface through operator[] vs. the bulk kernels on each instruction set,
+    // plus the remaining bulk operations on the best instruction set.
+    int surface_kernels()
+    {
+        constexpr hal::pixel::point size { 2048, 2048 };
+        constexpr std::size_t       runs { 20 };
+
+        using hal::detail::kernels::isa;
+
+        hal::surface s { size };
+        s.fill(hal::palette::orange);
+
+        const auto per_pixel = [&]()
+        {
+            for (hal::pixel::point i { 0, 0 }; i.y < size.y; ++i.y)
+            {
+                for (i.x = 0; i.x < size.x; ++i.x)
+                {
+                    auto px { s[i] };
+                    px.color(-px.color());
+                }
+            }
+        };
+
+        report("operator[] invert", measure(1, per_pixel));
+
+        constexpr std::pair<std::string_view, isa> sets[] {
+            { "scalar invert", isa::scalar },
+            { "SSE2 invert", isa::sse2 },
+            { "AVX2 invert", isa::avx2 }
+        };
+
+        for (const auto& [name, set] : sets)
+        {
+            if (set > hal::detail::kernels::supported_isa())
+                continue;
+
+            hal::detail::kernels::restrict_isa(set);
+            report(name, measure(runs, [&]()
+                             { s.invert(); }));
+        }
+
+        hal::detail::kernels::restrict_isa(isa::avx2);
+
+        const std::pair<std::string_view, hal::func_ptr<void, hal::view<hal::surface>>> ops[] {
+            { "multiply", [](hal::view<hal::surface> v)
+                { v.multiply(hal::palette::weezer_blue); } },
+            { "premultiply", [](hal::view<hal::surface> v)
+                { v.premultiply(); } },
+            { "grayscale", [](hal::view<hal::surface> v)
+                { v.grayscale(); } },
+            { "swizzle", [](hal::view<hal::surface> v)
+                { v.swizzle(hal::channel::b, hal::channel::g, hal::channel::r, hal::channel::a); } },
+            { "transform", [](hal::view<hal::surface> v)
+                { v.transform([](hal::color c)
+                      { return -c; }); } }
+        };
+
+        for (const auto& [name, op] : ops)
+        {
+            report(name, measure(runs, [&]()
+                             { op(s); }));
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Converting, resizing, filling and processing an 8K surface with increasing thread counts.
+    int surface_bands()
+    {
+        constexpr hal::pixel::point size { 7680, 4320 };
+        constexpr std::size_t       runs { 5 };
+
+        hal::surface s { size };
+        s.fill(hal::palette::orange);
+
+        const std::size_t max_threads { std::max<std::size_t>(std::thread::hardware_concurrency(), 1) };
+
+        for (std::size_t threads { 1 }; threads <= max_threads; threads *= 2)
+        {
+            hal::thread_pool pool { threads - 1 };
+
+            const auto convert = [&]()
+            {
+                const hal::surface converted { s.convert(hal::pixel::format::bgr24, pool) };
+            };
+
+            const auto resize = [&]()
+            {
+                const hal::surface resized { s.resize({ size.x / 2, size.y / 2 }, pool) };
+            };
+
+            const auto fill = [&]()
+            {
+                s.fill(hal::palette::weezer_blue, pool);
+            };
+
+            const auto user_kernel = [&]()
+            {
+                const hal::surface_view<hal::pixel::format::rgba32> sv { s };
+
+                s.for_each_band(pool, [&](hal::pixel_t begin, hal::pixel_t end)
+                    {
+                        for (hal::pixel_t y { begin }; y < end; ++y)
+                            for (hal::pixel::rgba32_t& px : sv.row(y))
+                                px.a = static_cast<hal::u8>(px.a / 2 + 64);
+                    });
+            };
+
+            std::cout << threads << " thread(s):\n";
+
+            report("  convert", measure(runs, convert));
+            report("  resize", measure(runs, resize));
+            report("  fill", measure(runs, fill));
+            report("  user kernel", measure(runs, user_kernel));
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Downscaling a large image with every filter, on one thread and on all of them.
+    int resample()
+    {
+        constexpr hal::pixel::point size { 4096, 4096 }, target { 512, 512 };
+        constexpr std::size_t       runs { 5 };
+
+        hal::surface s { size };
+
+        // Some structure, so that it isn't all one color.
+        const hal::surface_view<hal::pixel::format::rgba32> sv { s };
+
+        for (hal::pixel_t y { 0 }; y < size.y; ++y)
+            for (hal::pixel_t x { 0 }; x < size.x; ++x)
+                sv[{ x, y }] = { static_cast<hal::u8>(x), static_cast<hal::u8>(y), static_cast<hal::u8>(x ^ y), static_cast<hal::u8>(x + y) };
+
+        hal::thread_pool pool;
+
+        const std::pair<std::string_view, hal::filter> filters[] {
+            { "nearest", hal::filter::nearest },
+            { "box", hal::filter::box },
+            { "bilinear", hal::filter::bilinear },
+            { "bicubic", hal::filter::bicubic },
+            { "lanczos3", hal::filter::lanczos3 }
+        };
+
+        const hal::f64 megapixels { static_cast<hal::f64>(size.x) * size.y / 1'000'000.0 };
+
+        for (const auto& [name, f] : filters)
+        {
+            const auto single = [&]()
+            {
+                const hal::surface resized { s.resize(target, f) };
+            };
+
+            const auto pooled = [&]()
+            {
+                const hal::surface resized { s.resize(target, f, pool) };
+            };
+
+            const hal::f64 single_ms { measure(runs, single) }, pooled_ms { measure(runs, pooled) };
+
+            std::cout << name << ":\n";
+
+            report("  1 thread", single_ms);
+            report("  pool", pooled_ms);
+
+            std::cout << "  " << megapixels / single_ms * 1000.0 << " / " << megapixels / pooled_ms * 1000.0 << " MP/s\n";
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Per-frame CPU-generated content: recreating a static texture vs. streaming textures.
+    int streaming()
+    {
+        constexpr hal::pixel::point size { 1280, 720 }, dirty { 128, 128 };
+        constexpr std::size_t       frames { 200 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalBench: Streaming", size, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        std::vector<hal::u32> frame(static_cast<std::size_t>(size.x) * size.y);
+        hal::u32              counter { 0 };
+
+        // A new frame of content.
+        const auto generate = [&]()
+        {
+            ++counter;
+
+            for (std::size_t i { 0 }; i < frame.size(); ++i)
+                frame[i] = static_cast<hal::u32>(i) * 2654435761u + counter;
+        };
+
+        const std::span<const std::byte> bytes { std::as_bytes(std::span { frame }) };
+
+        const auto recreate = [&]()
+        {
+            generate();
+
+            hal::surface surf { size };
+
+            const hal::surface_view<hal::pixel::format::rgba32> sv { surf };
+
+            for (hal::pixel_t y { 0 }; y < size.y; ++y)
+                std::memcpy(sv.row(y).data(), frame.data() + y * size.x, size.x * sizeof(hal::u32));
+
+            const hal::static_texture tex { rnd.make_texture(surf) };
+
+            rnd.render(tex)();
+            rnd.present();
+        };
+
+        hal::streaming_texture stream { rnd.make_streaming_texture(size) };
+
+        const auto locked = [&]()
+        {
+            generate();
+
+            {
+                const hal::streaming_texture::lock_guard lock { stream.lock() };
+
+                for (hal::pixel_t y { 0 }; y < size.y; ++y)
+                    std::memcpy(lock.row(y).data(), frame.data() + y * size.x, size.x * sizeof(hal::u32));
+            }
+
+            rnd.render(stream)();
+            rnd.present();
+        };
+
+        const auto updated = [&]()
+        {
+            generate();
+
+            stream.update({ 0, 0, size.x, size.y }, bytes);
+
+            rnd.render(stream)();
+            rnd.present();
+        };
+
+        hal::buffered_texture buffered { rnd.make_buffered_texture(size) };
+
+        const auto partial = [&]()
+        {
+            generate();
+
+            // Only a small area changes each frame.
+            const hal::pixel::point pos { static_cast<hal::pixel_t>(counter * 37 % (size.x - dirty.x)), static_cast<hal::pixel_t>(counter * 23 % (size.y - dirty.y)) };
+
+            buffered.update({ pos.x, pos.y, dirty.x, dirty.y }, bytes.subspan((pos.y * size.x + pos.x) * sizeof(hal::u32)), static_cast<int>(size.x * sizeof(hal::u32)));
+            buffered.swap();
+
+            rnd.render(buffered.front())();
+            rnd.present();
+        };
+
+        report("static_texture per frame", measure(frames, recreate));
+        report("streaming_texture (lock)", measure(frames, locked));
+        report("streaming_texture (update)", measure(frames, updated));
+        report("buffered_texture (partial)", measure(frames, partial));
+
+        return EXIT_SUCCESS;
+    }
+
+    // Sprites from many textures, interleaved: one copyer per sprite vs. a sorting render queue.
+    int render_queue()
+    {
+        constexpr hal::pixel::point size { 1280, 720 };
+        constexpr std::size_t       sprites { 10'000 }, textures { 16 }, frames { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalBench: Render queue", size, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        std::vector<hal::static_texture> texs;
+
+        for (std::size_t i { 0 }; i < textures; ++i)
+        {
+            hal::surface surf { { 16, 16 } };
+            surf.fill(hal::color { static_cast<hal::u8>(i * 16), 128, static_cast<hal::u8>(255 - i * 16) });
+
+            texs.push_back(rnd.make_texture(surf));
+        }
+
+        hal::render_queue queue { rnd.make_render_queue() };
+
+        std::size_t calls { 0 };
+
+        const auto per_call = [&]()
+        {
+            scatter pos { size };
+
+            for (std::size_t i { 0 }; i < sprites; ++i)
+                rnd.render(texs[i % textures]).to(pos())();
+
+            rnd.present();
+        };
+
+        const auto queued = [&]()
+        {
+            scatter pos { size };
+
+            for (std::size_t i { 0 }; i < sprites; ++i)
+                queue.draw(texs[i % textures]).to(pos()).layer(static_cast<hal::u8>(i % 2))();
+
+            rnd.present();
+            calls = queue.draw_calls();
+        };
+
+        report("copyer", measure(frames, per_call));
+        std::cout << "  " << sprites << " draw calls\n";
+
+        report("render_queue", measure(frames, queued));
+        std::cout << "  " << calls << " draw calls\n";
+
+        return EXIT_SUCCESS;
+    }
+
+    // Loading a large PNG through buffered file reads vs. a memory mapping.
+    int mapped_load()
+    {
+        constexpr hal::pixel::point size { 2048, 2048 };
+        constexpr std::size_t       loads { 20 };
+
+        hal::context       ctx;
+        hal::image::context img { { hal::image::init_format::png } };
+
+        const std::string path { (std::filesystem::temp_directory_path() / "halbench_mapped.png").string() };
+
+        // Noise, so that the file doesn't compress down to nothing.
+        {
+            hal::surface surf { size };
+
+            const hal::surface_view<hal::pixel::format::rgba32> sv { surf };
+
+            scatter rng { { 256, 256 } };
+
+            for (hal::pixel_t y { 0 }; y < size.y; ++y)
+                for (hal::pixel::rgba32_t& px : sv.row(y))
+                {
+                    const hal::coord::point pt { rng() };
+                    px = { static_cast<hal::u8>(pt.x), static_cast<hal::u8>(pt.y), static_cast<hal::u8>(pt.x + pt.y), 255 };
+                }
+
+            img.save(surf, hal::image::save_format::png, hal::outputter { path });
+        }
+
+        report("accessor (file)", measure(loads, [&]()
+            { const hal::surface s { img.load(hal::accessor { path }) }; }));
+
+        report("accessor (mapped)", measure(loads, [&]()
+            { const hal::surface s { img.load(hal::accessor { path, hal::tag::mapped }) }; }));
+
+        std::filesystem::remove(path);
+
+        return EXIT_SUCCESS;
+    }
+
+    // Loading many small PNGs as loose files vs. from an archive.
+    int archive()
+    {
+        constexpr std::size_t files { 5000 }, runs { 5 };
+
+        hal::context        ctx;
+        hal::image::context img { { hal::image::init_format::png } };
+
+        const std::filesystem::path dir { std::filesystem::temp_directory_path() / "halbench_archive" };
+        const std::string           arc_path { (dir / "assets.hla").string() };
+
+        std::filesystem::create_directories(dir);
+
+        std::vector<std::string> names;
+        names.reserve(files);
+
+        hal::archive::writer wrt;
+
+        {
+            hal::surface surf { { 32, 32 } };
+
+            for (std::size_t i { 0 }; i < files; ++i)
+            {
+                surf.fill(hal::color { static_cast<hal::u8>(i), static_cast<hal::u8>(i >> 8), 128 });
+
+                names.push_back(hal::string_from_pack("sprite_", i, ".png"));
+
+                const std::string path { (dir / names.back()).string() };
+
+                img.save(surf, hal::image::save_format::png, hal::outputter { path });
+                wrt.add(names.back(), path.c_str());
+            }
+
+            wrt.save(hal::outputter { arc_path });
+        }
+
+        const hal::archive arc { arc_path };
+
+        report("loose files", measure(runs, [&]()
+            {
+                for (const std::string& name : names)
+                    const hal::surface s { img.load(hal::accessor { (dir / name).string() }) };
+            }));
+
+        report("archive", measure(runs, [&]()
+            {
+                for (const std::string& name : names)
+                    const hal::surface s { img.load(arc.open(name)) };
+            }));
+
+        std::filesystem::remove_all(dir);
+
+        return EXIT_SUCCESS;
+    }
+
+    // Latency of queueing a debug message. Bursts stay below the queue's capacity, so this
+    // measures the caller's cost rather than how fast the background thread can write.
+    int logging()
+    {
+#ifdef HAL_DEBUG_ENABLED
+        constexpr std::size_t bursts { 200 }, burst { 512 };
+
+        // Keep the console out of it.
+        std::streambuf* const prev { std::cout.rdbuf(nullptr) };
+
+        hal::f64 total { 0.0 };
+
+        for (std::size_t b { 0 }; b < bursts; ++b)
+        {
+            std::size_t i { 0 };
+
+            total += bench::measure(burst, [&]()
+                { hal::debug::print("Frame ", i++, " took ", 16.6, "ms"); });
+
+            hal::debug::flush();
+        }
+
+        std::cout.rdbuf(prev);
+        std::cout.clear();
+
+        std::cout << "Log enqueue: " << total / bursts * 1'000'000.0 << " ns\n";
+#else
+        std::cout << "Debugging is disabled, nothing to measure.\n";
+#endif
+
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    constexpr std::pair<std::string_view, hal::func_ptr<int>> benchmarks[] {
+        { "--sprite-batch", bench::sprite_batch },
+        { "--atlas", bench::atlas },
+        { "--glyph-cache", bench::glyph_cache },
+        { "--surface-kernels", bench::surface_kernels },
+        { "--surface-bands", bench::surface_bands },
+        { "--resample", bench::resample },
+        { "--streaming", bench::streaming },
+        { "--render-queue", bench::render_queue },
+        { "--mapped-load", bench::mapped_load },
+        { "--archive", bench::archive },
+        { "--logging", bench::logging }
+    };
+
+    if (argc == 1)
+    {
+        std::cout << "No benchmark given.\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto iter = std::find_if(std::begin(benchmarks), std::end(benchmarks), [&](const auto& pair)
+        { return pair.first == argv[1]; });
+
+    if (iter == std::end(benchmarks))
+    {
+        std::cout << "Invalid option specified: " << argv[1] << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return iter->second();
+}
\ No newline at end of file
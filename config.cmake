@@ -5,6 +5,13 @@ find_package(SDL2       REQUIRED CONFIG)
 find_package(SDL2_image REQUIRED CONFIG)
 find_package(SDL2_ttf   REQUIRED CONFIG)
 
+# Thread pools need a threading library on some platforms.
+find_package(Threads REQUIRED)
+
+# Archive entry compression is optional.
+find_package(lz4  CONFIG QUIET)
+find_package(zstd CONFIG QUIET)
+
 # Include directores.
 set(HALCYON_INCLUDE_DIRS ${CMAKE_CURRENT_LIST_DIR}/include/)
 
@@ -14,24 +21,43 @@ audio/device.cpp
 audio/spec.cpp
 audio/stream.cpp
 events/holder.cpp
+events/input.cpp
 events/keyboard.cpp
 events/mouse.cpp
+internal/file_map.cpp
+internal/kernels.cpp
+internal/logger.cpp
+internal/packer.cpp
+internal/resample.cpp
 internal/rwops.cpp
 internal/string.cpp
 types/color.cpp
+utility/frame_pacer.cpp
+utility/output_buffer.cpp
 utility/strutil.cpp
+utility/thread_pool.cpp
 utility/timer.cpp
+video/atlas.cpp
+video/command_buffer.cpp
 video/display.cpp
 video/driver.cpp
+video/glyph_cache.cpp
+video/mesh.cpp
 video/message_box.cpp
+video/primitive_batch.cpp
+video/render_queue.cpp
 video/renderer.cpp
+video/sprite_batch.cpp
 video/texture.cpp
+video/upload_queue.cpp
 video/window.cpp
+archive.cpp
 audio.cpp
 context.cpp
 debug.cpp
 events.cpp
 image.cpp
+profiler.cpp
 surface.cpp
 templates.cpp
 ttf.cpp
@@ -46,8 +72,25 @@ SDL2::SDL2main
 SDL2::SDL2
 SDL2_image::SDL2_image
 SDL2_ttf::SDL2_ttf
+Threads::Threads
 )
 
+if (TARGET LZ4::lz4)
+    list(APPEND HALCYON_LIBRARIES LZ4::lz4)
+    add_compile_definitions(HAL_ARCHIVE_LZ4)
+elseif (TARGET LZ4::lz4_shared)
+    list(APPEND HALCYON_LIBRARIES LZ4::lz4_shared)
+    add_compile_definitions(HAL_ARCHIVE_LZ4)
+endif()
+
+if (TARGET zstd::libzstd)
+    list(APPEND HALCYON_LIBRARIES zstd::libzstd)
+    add_compile_definitions(HAL_ARCHIVE_ZSTD)
+elseif (TARGET zstd::libzstd_shared)
+    list(APPEND HALCYON_LIBRARIES zstd::libzstd_shared)
+    add_compile_definitions(HAL_ARCHIVE_ZSTD)
+endif()
+
 # Halcyon uses C++23 features.
 set(CMAKE_CXX_STANDARD 23)
 set(CMAKE_CXX_STANDARD_REQUIRED ON)
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include <filesystem>
+#include <iostream>
+
+#include <halcyon/archive.hpp>
+
+#include <halcyon/utility/metaprogramming.hpp>
+
+// archiver.cpp:
+// Packs files and directories into a Halcyon archive.
+
+int main(int argc, char* argv[])
+{
+    static_assert(hal::meta::is_correct_main<main>);
+
+    if (argc < 3)
+    {
+        std::cout << "Usage: " << argv[0] << " [output] [--lz4 | --zstd] [files or directories...]\n";
+        return EXIT_FAILURE;
+    }
+
+    namespace fs = std::filesystem;
+
+    hal::archive::compression method { hal::archive::compression::none };
+
+    hal::archive::writer wrt;
+
+    for (int i { 2 }; i < argc; ++i)
+    {
+        const std::string_view arg { argv[i] };
+
+        if (arg == "--lz4" || arg == "--zstd")
+        {
+            method = arg == "--lz4" ? hal::archive::compression::lz4 : hal::archive::compression::zstd;
+
+            if (!hal::archive::supports(method))
+            {
+                std::cout << arg.substr(2) << " compression isn't available in this build.\n";
+                return EXIT_FAILURE;
+            }
+
+            continue;
+        }
+
+        const fs::path root { arg };
+
+        if (!fs::is_directory(root))
+        {
+            wrt.add(root.filename().generic_string(), argv[i], method);
+            continue;
+        }
+
+        // Entries are named by their path within the directory.
+        for (const fs::directory_entry& ent : fs::recursive_directory_iterator { root })
+        {
+            if (ent.is_regular_file())
+                wrt.add(fs::relative(ent.path(), root).generic_string(), ent.path().string().c_str(), method);
+        }
+    }
+
+    wrt.save(argv[1]);
+
+    std::cout << "Packed " << wrt.size() << " entries into " << argv[1] << '\n';
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
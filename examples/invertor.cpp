@@ -32,16 +32,11 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    const hal::pixel::point size { surf.size() };
+    // Bulk operations need 32-bit pixels with an alpha channel.
+    if (surf.pixel_format() != hal::pixel::format::rgba32)
+        surf = surf.convert(hal::pixel::format::rgba32);
 
-    for (hal::pixel::point i { 0, 0 }; i.y < size.y; ++i.y)
-    {
-        for (i.x = 0; i.x < size.x; ++i.x)
-        {
-            auto col { surf[i] };
-            col.color(-col.color());
-        }
-    }
+    surf.invert();
 
     ctx.save(surf, hal::image::save_format::png, "invert.png");
 
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <halcyon/internal/file_map.hpp>
+#include <halcyon/internal/rwops.hpp>
+
+// archive.hpp:
+// Packed asset archives.
+
+namespace hal
+{
+    // A Halcyon archive packs many files into one, so that opening an asset is a lookup in
+    // a memory-mapped index rather than a filesystem call.
+    // Layout (integers are little-endian):
+    //  - header:  magic, version, entry count, name table size,
+    //  - index:   one record per entry, sorted by name hash,
+    //  - names:   entry names, back to back,
+    //  - data:    entry contents, each aligned to archive::alignment bytes.
+    // Entries can be individually compressed with LZ4 or zstd, if the build has them.
+    // Create archives with archive::writer, or the "archiver" example tool.
+    class archive
+    {
+    public:
+        enum class compression : u8
+        {
+            none,
+            lz4,
+            zstd
+        };
+
+        static constexpr std::size_t alignment { 16 };
+
+        // Check whether this build can (de)compress entries with a method.
+        static constexpr bool supports(compression method)
+        {
+            switch (method)
+            {
+            case compression::none:
+                return true;
+
+            case compression::lz4:
+#ifdef HAL_ARCHIVE_LZ4
+                return true;
+#else
+                return false;
+#endif
+
+            case compression::zstd:
+#ifdef HAL_ARCHIVE_ZSTD
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            return false;
+        }
+
+        class writer;
+
+        archive() = default;
+
+        // Map an archive file.
+        archive(const char* path);
+        archive(std::nullptr_t) = delete;
+
+        // Map an archive file.
+        archive(std::string_view path);
+
+        // Access an entry. Uncompressed entries are read straight from the mapping, so the
+        // archive must outlive the accessor (until it's consumed); compressed entries get
+        // decompressed into memory owned by the accessor.
+        [[nodiscard]] accessor open(std::string_view name) const;
+
+        bool contains(std::string_view name) const;
+
+        // Get the amount of entries.
+        std::size_t size() const;
+
+        // Get an entry's name, in index order.
+        std::string_view name(std::size_t index) const;
+
+        bool valid() const;
+
+    private:
+        struct record
+        {
+            u64 hash, offset;
+            u32 size, stored_size;
+            u32 name_offset;
+            u16 name_size;
+
+            enum compression method;
+
+            u8 reserved;
+
+            // Convert between native and archive (little-endian) byte order.
+            // Converting twice gives back the original.
+            record little_endian() const;
+        };
+
+        static_assert(sizeof(record) == 32);
+
+        const record* find(std::string_view name) const;
+
+        detail::file_map m_map;
+
+        // Decoded from the mapping, so that it's in native byte order.
+        std::vector<record> m_records;
+        const char*         m_names { nullptr };
+    };
+
+    // Builds an archive in memory, then writes it out all at once.
+    class archive::writer
+    {
+    public:
+        // Add an entry. Compressed entries are stored uncompressed if that ends up smaller.
+        void add(std::string_view name, std::span<const std::byte> data, compression method = compression::none);
+
+        // Add a file as an entry.
+        void add(std::string_view name, const char* path, compression method = compression::none);
+
+        // Get the amount of entries added so far.
+        std::size_t size() const;
+
+        void save(outputter dst) const;
+
+    private:
+        struct pending
+        {
+            std::string            name;
+            std::vector<std::byte> data;
+
+            u32 size;
+
+            enum compression method;
+        };
+
+        std::vector<pending> m_entries;
+    };
+}
\ No newline at end of file
@@ -7,20 +7,28 @@
 //  - HAL_DEBUG_ENABLED enables debugging.
 //  - HAL_DEBUG_ADVANCED additionally provides timestamps and logs to an output file.
 //  - if NDEBUG is defined, both of the aforementioned macros are implicitly defined as well.
+//  - HAL_DEBUG_MIN_SEVERITY sets the least severe output that's kept: 0 keeps everything,
+//    1 keeps warnings and errors, 2 keeps errors only. Filtered-out macros compile to nothing,
+//    without evaluating their arguments.
+
+// HAL_PRINT is for info-level output (including init and load messages); use HAL_WARN for
+// warnings and HAL_PRINT_ERR for errors, so that each macro's severity is known when filtering.
 
 #ifndef NDEBUG
     #define HAL_DEBUG_ENABLED
     #define HAL_DEBUG_ADVANCED
 #endif
 
-#ifdef HAL_DEBUG_ENABLED
+#ifndef HAL_DEBUG_MIN_SEVERITY
+    #define HAL_DEBUG_MIN_SEVERITY 0
+#endif
 
-    #ifdef HAL_DEBUG_ADVANCED
-        #include <fstream>
-    #endif
+#ifdef HAL_DEBUG_ENABLED
 
     #include <iostream>
 
+    #include <halcyon/internal/logger.hpp>
+
     #include <halcyon/utility/printing.hpp>
     #include <halcyon/utility/strutil.hpp>
     #include <halcyon/utility/timer.hpp>
@@ -57,6 +65,8 @@ namespace hal
             false
 #endif
         };
+
+        constexpr int debug_min_severity { HAL_DEBUG_MIN_SEVERITY };
     }
 
     class debug
@@ -81,9 +91,14 @@ namespace hal
 
 #ifdef HAL_DEBUG_ENABLED
         // Output any amount of arguments to stdout/stderr and an output file.
+        // Output is asynchronous: arguments are copied and written out on a background thread.
         template <meta::printable... Args>
         static void print(Args&&... extra_info)
         {
+            // Checked here too for direct calls; the macros are filtered by the preprocessor.
+            if (level_of(severity::info) < compile_settings::debug_min_severity)
+                return;
+
             debug::print_severity(severity::info, std::forward<Args>(extra_info)...);
         }
 
@@ -92,6 +107,10 @@ namespace hal
         template <meta::printable... Args>
         static void print(severity sev, Args&&... extra_info)
         {
+            // Usually given a constant, in which case this gets folded away.
+            if (level_of(sev) < compile_settings::debug_min_severity)
+                return;
+
             debug::print_severity(sev, std::forward<Args>(extra_info)...);
         }
 
@@ -100,7 +119,8 @@ namespace hal
         template <meta::printable... Args>
         [[noreturn]] static void panic(std::string_view function, std::string_view file, u32 line, Args&&... extra_info)
         {
-            debug::print_severity(severity::error, string_from_pack(std::forward<Args>(extra_info)...), " [", function, ", ", file, ':', line, "]");
+            debug::print_severity(severity::error, std::forward<Args>(extra_info)..., " [", function, ", ", file, ':', line, "]");
+            debug::flush();
 
             std::exit(EXIT_FAILURE);
         }
@@ -118,6 +138,12 @@ namespace hal
                 debug::warn(std::forward<Args>(extra_info)...);
         }
 
+        // Wait until all messages printed so far have been written out.
+        static void flush()
+        {
+            detail::log::flush();
+        }
+
         // Check a condition, and panic if it's false.
         template <meta::printable... Args>
         static void verify(bool condition, std::string_view cond_string, std::string_view func, std::string_view file, u32 line,
@@ -131,68 +157,79 @@ namespace hal
         template <meta::printable... Args>
         static void print_severity(severity type, Args&&... extra_info)
         {
-            std::stringstream fwd;
+            detail::log::write(prefix_of(type), type == severity::error, extra_info...);
+        }
 
-    #ifdef HAL_DEBUG_ADVANCED
-            fwd << std::fixed << std::setprecision(3) << '[' << m_timer()
-                << "s] ";
-    #endif
+        // Severities ranked for HAL_DEBUG_MIN_SEVERITY.
+        static constexpr int level_of(severity type)
+        {
+            using enum severity;
+
+            switch (type)
+            {
+            case warning:
+                return 1;
+
+            case error:
+                return 2;
+
+            default:
+                return 0;
+            }
+        }
 
+        static constexpr std::string_view prefix_of(severity type)
+        {
             using enum severity;
 
             switch (type)
             {
             case info:
-                fwd << "[info]  ";
-                break;
+                return "[info]  ";
 
             case warning:
-                fwd << "[WARN]  ";
-                break;
+                return "[WARN]  ";
 
             case error:
-                fwd << "[ERROR] ";
-                break;
+                return "[ERROR] ";
 
             case init:
-                fwd << "[init]  ";
-                break;
+                return "[init]  ";
 
             case load:
-                fwd << "[load]  ";
-                break;
+                return "[load]  ";
 
             default:
-                fwd << "[????]  ";
-                break;
+                return "[????]  ";
             }
-
-            const std::string with_info { fwd.str() + string_from_pack(extra_info...) };
-
-    #ifdef HAL_DEBUG_ADVANCED
-            m_output << with_info << std::endl;
-    #endif
-
-            (type == error ? std::cerr : std::cout) << with_info << std::endl;
         }
-
-    #ifdef HAL_DEBUG_ADVANCED
-        static std::ofstream m_output;
-        static const timer   m_timer;
-    #endif
 #endif
     };
 }
 
 #ifdef HAL_DEBUG_ENABLED
 
-    #define HAL_PRINT      ::hal::debug::print
+    #if HAL_DEBUG_MIN_SEVERITY < 1
+        #define HAL_PRINT(...) ::hal::debug::print(__VA_ARGS__)
+    #else
+        #define HAL_PRINT(...) (static_cast<void>(0))
+    #endif
+
+    #define HAL_PRINT_ERR(...) ::hal::debug::print(::hal::debug::severity::error, __VA_ARGS__)
+
     #define HAL_PANIC(...) ::hal::debug::panic(__PRETTY_FUNCTION__, __FILE_NAME__, __LINE__, __VA_ARGS__)
 
-    #define HAL_WARN(...) ::hal::debug::warn(__VA_ARGS__)
+    #if HAL_DEBUG_MIN_SEVERITY < 2
+        #define HAL_WARN(...) ::hal::debug::warn(__VA_ARGS__)
 
-    #define HAL_WARN_IF(cond, ...)       HAL_WARN_IF_VITAL(cond, __VA_ARGS__)
-    #define HAL_WARN_IF_VITAL(cond, ...) ::hal::debug::warn_if(cond, __VA_ARGS__)
+        #define HAL_WARN_IF(cond, ...)       HAL_WARN_IF_VITAL(cond, __VA_ARGS__)
+        #define HAL_WARN_IF_VITAL(cond, ...) ::hal::debug::warn_if(cond, __VA_ARGS__)
+    #else
+        #define HAL_WARN(...) (static_cast<void>(0))
+
+        #define HAL_WARN_IF(...)             (static_cast<void>(0))
+        #define HAL_WARN_IF_VITAL(cond, ...) (static_cast<void>(cond))
+    #endif
 
     #define HAL_ASSERT(cond, ...) HAL_ASSERT_VITAL(cond, __VA_ARGS__)
     #define HAL_ASSERT_VITAL(cond, ...) \
@@ -200,8 +237,9 @@ namespace hal
 
 #else
 
-    #define HAL_PRINT(...) (static_cast<void>(0))
-    #define HAL_PANIC(...) std::unreachable()
+    #define HAL_PRINT(...)     (static_cast<void>(0))
+    #define HAL_PRINT_ERR(...) (static_cast<void>(0))
+    #define HAL_PANIC(...)     std::unreachable()
 
     #define HAL_WARN(...) (static_cast<void>(0))
 
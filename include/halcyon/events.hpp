@@ -1,6 +1,7 @@
 #pragma once
 
 #include <halcyon/events/holder.hpp>
+#include <halcyon/events/input.hpp>
 
 #include <halcyon/internal/subsystem.hpp>
 
@@ -57,6 +58,10 @@ namespace hal
 
             bool poll(event::holder& eh);
 
+            // Move every pending event into a batch, replacing its contents.
+            // Returns the amount of events fetched.
+            std::size_t poll(event::batch& b);
+
             void push(const event::holder& eh);
 
             bool pending();
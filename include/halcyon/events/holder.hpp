@@ -1,5 +1,10 @@
 #pragma once
 
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <vector>
+
 #include <halcyon/events/keyboard.hpp>
 #include <halcyon/events/mouse.hpp>
 
@@ -216,6 +221,10 @@ namespace hal
             clipboard_updated = SDL_CLIPBOARDUPDATE
         };
 
+        // An event type as a compile-time constant, for use with holder::visit().
+        template <type T>
+        using on = std::integral_constant<type, T>;
+
         class holder
         {
         public:
@@ -258,6 +267,76 @@ namespace hal
             // Check whether there are any pending event in the event queue.
             bool pending() const;
 
+            // Call a function with this event's type as a compile-time constant and,
+            // if the type carries one, its data - func(on<T>) or func(on<T>, const Data&).
+            // Types the function can't be called with are skipped. Since the type is
+            // checked once by the switch, the data isn't re-checked like with accessors.
+            template <typename F>
+            void visit(F&& func) const
+            {
+                const auto call = [&]<type T>(on<T> tag, const auto&... data)
+                {
+                    if constexpr (std::invocable<F&, on<T>, decltype(data)...>)
+                        func(tag, data...);
+                };
+
+                using enum type;
+
+                switch (kind())
+                {
+                case quit_requested:
+                    return call(on<quit_requested> {});
+
+                case terminated:
+                    return call(on<terminated> {});
+
+                case low_memory:
+                    return call(on<low_memory> {});
+
+                case will_enter_background:
+                    return call(on<will_enter_background> {});
+
+                case entered_background:
+                    return call(on<entered_background> {});
+
+                case will_enter_foreground:
+                    return call(on<will_enter_foreground> {});
+
+                case entered_foreground:
+                    return call(on<entered_foreground> {});
+
+                case display_event:
+                    return call(on<display_event> {}, m_event.data.display);
+
+                case window_event:
+                    return call(on<window_event> {}, m_event.data.window);
+
+                case key_pressed:
+                    return call(on<key_pressed> {}, m_event.data.key);
+
+                case key_released:
+                    return call(on<key_released> {}, m_event.data.key);
+
+                case text_input:
+                    return call(on<text_input> {}, m_event.data.text_input);
+
+                case mouse_moved:
+                    return call(on<mouse_moved> {}, m_event.data.motion);
+
+                case mouse_pressed:
+                    return call(on<mouse_pressed> {}, m_event.data.button);
+
+                case mouse_released:
+                    return call(on<mouse_released> {}, m_event.data.button);
+
+                case mouse_wheel_moved:
+                    return call(on<mouse_wheel_moved> {}, m_event.data.wheel);
+
+                case clipboard_updated:
+                    return call(on<clipboard_updated> {});
+                }
+            }
+
             SDL_Event* get(pass_key<proxy::events>) const;
 
         private:
@@ -286,6 +365,41 @@ namespace hal
 
             static_assert(sizeof(m_event) == sizeof(SDL_Event));
         };
+
+        static_assert(sizeof(holder) == sizeof(SDL_Event));
+
+        // Events fetched all at once, stored contiguously. See proxy::events::poll().
+        class batch
+        {
+        public:
+            // Create a batch with space for a number of events. It grows as needed.
+            batch(std::size_t capacity = 256);
+
+            // Call a function for every event in the batch, as with holder::visit().
+            template <typename F>
+            void dispatch(F&& func) const
+            {
+                for (const holder& eh : events())
+                    eh.visit(func);
+            }
+
+            std::span<const holder> events() const;
+
+            const holder* begin() const;
+            const holder* end() const;
+
+            std::size_t size() const;
+            bool        empty() const;
+
+            // [private] Event fetching.
+            void              clear(pass_key<proxy::events>);
+            std::span<holder> space(pass_key<proxy::events>);
+            void              commit(std::size_t count, pass_key<proxy::events>);
+
+        private:
+            std::vector<holder> m_events;
+            std::size_t         m_size { 0 };
+        };
     }
 
     constexpr std::string_view to_string(event::type evt)
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <bitset>
+
+#include <halcyon/events/holder.hpp>
+
+#include <halcyon/utility/triple_buffer.hpp>
+
+// events/input.hpp:
+// Per-frame input snapshots, readable from other threads.
+
+namespace hal
+{
+    namespace input
+    {
+        // The state of the keyboard and mouse as of the end of a frame.
+        struct snapshot
+        {
+            // Held keyboard buttons, indexed by scancode.
+            std::bitset<SDL_NUM_SCANCODES> keys;
+
+            // Held mouse buttons, as in mouse::state::mask().
+            u8 buttons { 0 };
+
+            // Mouse position within the focused window, its movement and the
+            // amount scrolled during the frame.
+            pixel::point pos { 0, 0 }, delta { 0, 0 };
+            point<f32>   wheel { 0.0f, 0.0f };
+
+            // The frame's number, starting at 1 for the first published frame.
+            u64 frame { 0 };
+
+            bool operator[](keyboard::button btn) const;
+            bool operator[](mouse::button btn) const;
+        };
+
+        // Builds input snapshots out of events and publishes them through a triple buffer,
+        // so that another thread (e.g. the simulation) can read a consistent frame of input
+        // without locks and without calling into SDL.
+        // Feed it events on the event thread, either one by one or via batch::dispatch(),
+        // then call publish() once per frame.
+        class tracker
+        {
+        public:
+            // Feed a single event. Events irrelevant to input are ignored.
+            void feed(const event::holder& eh);
+
+            // Handlers for holder::visit() and batch::dispatch().
+            void operator()(event::on<event::type::key_pressed>, const event::keyboard& e);
+            void operator()(event::on<event::type::key_released>, const event::keyboard& e);
+            void operator()(event::on<event::type::mouse_moved>, const event::mouse_motion& e);
+            void operator()(event::on<event::type::mouse_pressed>, const event::mouse_button& e);
+            void operator()(event::on<event::type::mouse_released>, const event::mouse_button& e);
+            void operator()(event::on<event::type::mouse_wheel_moved>, const event::mouse_wheel& e);
+
+            // [Event thread] Publish the current frame's input and start a new frame.
+            void publish();
+
+            // [Event thread] The input gathered so far this frame.
+            const snapshot& current() const;
+
+            // [Reader thread] The latest published frame. Only one thread may read;
+            // the reference stays valid until that thread's next call.
+            const snapshot& latest();
+
+        private:
+            snapshot                m_current;
+            triple_buffer<snapshot> m_published;
+        };
+    }
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <future>
+#include <vector>
+
 #include <SDL_image.h>
 
 #include <halcyon/surface.hpp>
@@ -74,6 +78,18 @@ namespace hal
             // Load an image, knowing the format in advance.
             [[nodiscard]] surface load(accessor src, load_format fmt) const;
 
+            // Decode an image on a thread pool.
+            // The context must outlive the decoding; upload the result on the render thread (see upload_queue).
+            [[nodiscard]] std::future<surface> load(accessor src, thread_pool& pool) const;
+
+            // Decode a batch of images on a thread pool.
+            // Futures are in the same order as the sources.
+            [[nodiscard]] std::vector<std::future<surface>> load(std::vector<accessor> srcs, thread_pool& pool) const;
+
+            // Decode an image on a thread pool and pass it to a function.
+            // The function is called on the decoding thread, so it must not touch the renderer.
+            void load(accessor src, thread_pool& pool, std::move_only_function<void(surface)> done) const;
+
             // Save a surface with a specified format.
             // JPEG files are currently saved at a hard-coded 90 quality.
             void save(view<const surface>, save_format fmt, outputter dst) const;
@@ -43,6 +43,15 @@ namespace hal::detail
             m_src.pos.x = unset_pos<src_t>();
         }
 
+        // Skips querying the source's size if it's already known.
+        [[nodiscard]] drawer(view<Pass> ths, view<T> src, const dst_point& src_size)
+            : m_pass { ths }
+            , m_this { src }
+            , m_dst { tag::as_size, src_size }
+        {
+            m_src.pos.x = unset_pos<src_t>();
+        }
+
         // Set where to draw.
         // Discards any previous scaling and anchoring.
         [[nodiscard]] this_ref to(const dst_point& pos)
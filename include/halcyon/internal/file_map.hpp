@@ -0,0 +1,49 @@
+#pragma once
+
+#include <span>
+
+#include <halcyon/types/numeric.hpp>
+
+// internal/file_map.hpp:
+// Read-only memory mapping of whole files.
+
+namespace hal::detail
+{
+    // A read-only view of a whole file's contents. The file is memory-mapped where the platform
+    // supports it, and read into memory otherwise. Empty and unreadable files result in an
+    // invalid map; files too large for SDL's memory RWops aren't supported either.
+    class file_map
+    {
+    public:
+        // How the data is going to be read. Used as a hint for the OS's read-ahead.
+        enum class access : u8
+        {
+            sequential, // Front to back, soon after mapping.
+            random      // In small scattered pieces.
+        };
+
+        file_map() = default;
+
+        file_map(const char* path, access hint);
+
+        file_map(const file_map&) = delete;
+        file_map(file_map&& other) noexcept;
+
+        file_map& operator=(file_map&& other) noexcept;
+
+        ~file_map();
+
+        std::span<const std::byte> data() const;
+
+        bool valid() const;
+
+        // Give up ownership of the data. It must later be freed with free().
+        std::span<const std::byte> release();
+
+        // Free data previously released from a map.
+        static void free(std::span<const std::byte> data);
+
+    private:
+        std::span<const std::byte> m_data;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+
+#include <halcyon/types/color.hpp>
+#include <halcyon/video/types.hpp>
+
+// internal/kernels.hpp:
+// Bulk pixel operations on 32-bit surfaces.
+
+namespace hal::detail::kernels
+{
+    // Where each channel sits within a 32-bit pixel value.
+    struct layout
+    {
+        u8 r, g, b, a;
+
+        constexpr color unpack(u32 px) const
+        {
+            return {
+                static_cast<color::value_t>(px >> r),
+                static_cast<color::value_t>(px >> g),
+                static_cast<color::value_t>(px >> b),
+                static_cast<color::value_t>(px >> a)
+            };
+        }
+
+        constexpr u32 pack(color c) const
+        {
+            return (static_cast<u32>(c.r) << r) | (static_cast<u32>(c.g) << g) | (static_cast<u32>(c.b) << b) | (static_cast<u32>(c.a) << a);
+        }
+    };
+
+    // A block of 32-bit pixels.
+    struct image
+    {
+        std::byte*   pixels;
+        int          pitch;
+        pixel::point size;
+        layout       fmt;
+
+        u32* row(pixel_t y) const
+        {
+            return reinterpret_cast<u32*>(pixels + y * pitch);
+        }
+    };
+
+    // Describe a surface for kernels.
+    // The surface must have a 32-bit format with an 8-bit alpha channel.
+    image image_of(SDL_Surface* surf);
+
+    // Instruction sets kernels can use.
+    enum class isa : u8
+    {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    // The best instruction set this CPU supports. Detected once.
+    isa supported_isa();
+
+    // The instruction set currently in use.
+    isa active_isa();
+
+    // Restrict kernels to an instruction set, for comparison purposes.
+    // Requests above what the CPU supports are clamped.
+    void restrict_isa(isa set);
+
+    void invert(const image& img);
+    void multiply(const image& img, color c);
+    void premultiply(const image& img);
+    void grayscale(const image& img);
+
+    // Each destination channel (R, G, B, A) takes its value from the source channel at the given index.
+    void swizzle(const image& img, std::array<u8, 4> src);
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <spanstream>
+#include <string_view>
+
+#if __has_include(<format>)
+    #include <format>
+#endif
+
+#include <halcyon/types/numeric.hpp>
+
+#include <halcyon/utility/concepts.hpp>
+
+// internal/logger.hpp:
+// Asynchronous backend of debug output.
+
+namespace hal
+{
+    struct color;
+
+    template <meta::arithmetic T>
+    struct point;
+
+    template <meta::arithmetic T>
+    struct rectangle;
+}
+
+namespace hal::detail::log
+{
+    // Messages are recorded in binary and formatted later, on a background thread:
+    //  - numbers, stream manipulators and a few plain value types are copied bit for bit,
+    //  - strings are copied, cut off if the message wouldn't fit otherwise,
+    //  - anything else is formatted right away, straight into the buffer - with std::format
+    //    if the type supports it, or an output stream over the buffer otherwise.
+    // Each record is encoded into a per-thread buffer, then pushed onto a bounded
+    // multi-producer, single-consumer ring. If the ring is full, the producer waits.
+    // Cut-off arguments end with an ellipsis.
+
+    using clock = std::chrono::steady_clock;
+
+    // Space for encoded arguments of a single message.
+    constexpr std::size_t payload_size { 448 };
+
+    template <typename T>
+    concept string_like = std::convertible_to<const T&, std::string_view>;
+
+    // Types that neither refer to other memory nor call into SDL when printed.
+    // Enums aren't included, as some of them print their names through SDL.
+    template <typename T>
+    constexpr bool plain_value { false };
+
+    template <>
+    inline constexpr bool plain_value<color> { true };
+
+    template <meta::arithmetic T>
+    constexpr bool plain_value<point<T>> { true };
+
+    template <meta::arithmetic T>
+    constexpr bool plain_value<rectangle<T>> { true };
+
+    // Formatted on the logging thread from a copy of their bits; everything else is formatted
+    // by the caller, which may change or free whatever the argument refers to right after.
+    template <typename T>
+    concept raw = std::is_arithmetic_v<T> || plain_value<T> || (std::is_pointer_v<T> && std::is_function_v<std::remove_pointer_t<T>>);
+
+    // How much space an argument takes up at minimum.
+    template <typename T>
+    consteval std::size_t fixed_size()
+    {
+        return raw<T> ? sizeof(T) : sizeof(u16);
+    }
+
+    // End a cut-off argument with an ellipsis, in place of its last characters.
+    inline void mark_truncated(char* out, std::size_t len)
+    {
+        constexpr std::string_view marker { "..." };
+
+        const std::size_t n { std::min(len, marker.size()) };
+        std::memcpy(out + len - n, marker.data(), n);
+    }
+
+    // Copy a string, leaving [reserve] bytes of space after it.
+    inline void encode_string(std::byte*& dst, const std::byte* end, std::size_t reserve, std::string_view str)
+    {
+        char* const       out { reinterpret_cast<char*>(dst + sizeof(u16)) };
+        const std::size_t room { static_cast<std::size_t>(end - dst) - sizeof(u16) - reserve };
+
+        const u16 len { static_cast<u16>(std::min(str.size(), room)) };
+
+        std::memcpy(dst, &len, sizeof(len));
+        std::memcpy(out, str.data(), len);
+
+        if (str.size() > room)
+            mark_truncated(out, len);
+
+        dst += sizeof(len) + len;
+    }
+
+    template <typename T>
+    void encode(std::byte*& dst, const std::byte* end, std::size_t reserve, const T& val)
+    {
+        if constexpr (string_like<T>)
+            encode_string(dst, end, reserve, std::string_view { val });
+
+        else if constexpr (raw<T>)
+        {
+            std::memcpy(dst, &val, sizeof(T));
+            dst += sizeof(T);
+        }
+
+        else
+        {
+            char* const       out { reinterpret_cast<char*>(dst + sizeof(u16)) };
+            const std::size_t room { static_cast<std::size_t>(end - dst) - sizeof(u16) - reserve };
+
+            u16  len;
+            bool cut;
+
+    #ifdef __cpp_lib_format
+            if constexpr (std::formattable<T, char>)
+            {
+                const std::size_t size { static_cast<std::size_t>(std::format_to_n(out, room, "{}", val).size) };
+
+                len = static_cast<u16>(std::min(size, room));
+                cut = size > room;
+            }
+
+            else
+    #endif
+            {
+                std::ospanstream str { std::span { out, room } };
+                str << val;
+
+                // Writing past the end of the span fails the stream.
+                len = static_cast<u16>(str.span().size());
+                cut = !str;
+            }
+
+            if (cut)
+                mark_truncated(out, len);
+
+            std::memcpy(dst, &len, sizeof(len));
+            dst += sizeof(len) + len;
+        }
+    }
+
+    inline void encode_all(std::byte*&, const std::byte*)
+    {
+    }
+
+    // Arguments are encoded as their decayed types, so that arrays and functions
+    // (like stream manipulators) become pointers.
+    template <typename T, typename... Rest>
+    void encode_all(std::byte*& dst, const std::byte* end, const T& val, const Rest&... rest)
+    {
+        encode<std::decay_t<const T&>>(dst, end, (fixed_size<std::decay_t<const Rest&>>() + ... + 0), val);
+        encode_all(dst, end, rest...);
+    }
+
+    template <typename T>
+    void decode(std::ostream& str, const std::byte*& src)
+    {
+        if constexpr (raw<T>)
+        {
+            std::array<std::byte, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), src, sizeof(T));
+
+            str << std::bit_cast<T>(bytes);
+            src += sizeof(T);
+        }
+
+        else
+        {
+            u16 len;
+            std::memcpy(&len, src, sizeof(len));
+
+            str << std::string_view { reinterpret_cast<const char*>(src + sizeof(len)), len };
+            src += sizeof(len) + len;
+        }
+    }
+
+    // Format a record's payload, given the types it was encoded with.
+    template <typename... Args>
+    void format(std::ostream& str, const std::byte* src)
+    {
+        (decode<Args>(str, src), ...);
+    }
+
+    struct header
+    {
+        void (*fmt)(std::ostream&, const std::byte*);
+
+        std::string_view  prefix;
+        clock::time_point time;
+        bool              error;
+    };
+
+    // The calling thread's encoding buffer.
+    std::span<std::byte, payload_size> local_buffer();
+
+    // Queue a record for output. Waits if the queue is full.
+    void push(const header& hdr, std::span<const std::byte> payload);
+
+    // Wait until everything queued so far has been written out.
+    void flush();
+
+    // Queue a message with a prefix. Errors go to stderr instead of stdout.
+    template <typename... Args>
+    void write(std::string_view prefix, bool error, const Args&... args)
+    {
+        static_assert((fixed_size<std::decay_t<const Args&>>() + ... + 0) <= payload_size, "Too many log message arguments");
+
+        const std::span<std::byte, payload_size> buf { local_buffer() };
+
+        std::byte* cursor { buf.data() };
+        encode_all(cursor, buf.data() + buf.size(), args...);
+
+        push({ format<std::decay_t<const Args&>...>, prefix, clock::now(), error }, { buf.data(), cursor });
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <halcyon/video/types.hpp>
+
+// internal/packer.hpp:
+// Rectangle packing for atlases.
+
+namespace hal::detail
+{
+    // A skyline bottom-left packer. Tracks the highest occupied point of every
+    // horizontal span of the page, and places new rectangles as low as possible.
+    // Rectangles can be inserted one by one, which makes it usable for both
+    // offline (sorted) and online (glyph cache) packing.
+    class skyline
+    {
+    public:
+        skyline() = default;
+
+        skyline(pixel::point size);
+
+        // Occupy a spot for a rectangle and return its position,
+        // or nothing if there's no room left for it.
+        std::optional<pixel::point> insert(pixel::point size);
+
+        // Forget about all inserted rectangles.
+        void clear();
+
+        pixel::point size() const;
+
+    private:
+        struct node
+        {
+            pixel_t x, y, width;
+        };
+
+        pixel::point      m_size;
+        std::vector<node> m_nodes;
+    };
+}
\ No newline at end of file
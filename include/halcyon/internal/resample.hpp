@@ -0,0 +1,14 @@
+#pragma once
+
+#include <halcyon/surface.hpp>
+
+// internal/resample.hpp:
+// Filtered surface scaling.
+
+namespace hal::detail
+{
+    // Resample a surface with a separable filter into a new surface of the default format.
+    // Filtering is done on premultiplied alpha, so transparent pixels don't bleed color.
+    // Rows are split among a thread pool's threads if one is given.
+    surface resample(view<const surface> src, pixel::point size, filter f, thread_pool* pool);
+}
\ No newline at end of file
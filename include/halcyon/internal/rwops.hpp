@@ -1,10 +1,14 @@
 #pragma once
 
+#include <functional>
+#include <iosfwd>
+#include <memory>
 #include <span>
 
 #include <SDL_rwops.h>
 
 #include <halcyon/internal/raii_object.hpp>
+#include <halcyon/internal/tags.hpp>
 
 #include <halcyon/utility/concepts.hpp>
 #include <halcyon/utility/pass_key.hpp>
@@ -15,6 +19,8 @@ namespace hal
 {
     class surface;
     class font;
+    class archive;
+    class output_buffer;
 
     namespace image
     {
@@ -26,6 +32,8 @@ namespace hal
         class rwops;
     }
 
+    HAL_TAG(mapped);
+
     template <>
     class view<detail::rwops> : public detail::view_base<SDL_RWops>
     {
@@ -33,6 +41,44 @@ namespace hal
         using view_base::view_base;
     };
 
+    enum class seek_origin : u8
+    {
+        begin   = RW_SEEK_SET,
+        current = RW_SEEK_CUR,
+        end     = RW_SEEK_END
+    };
+
+    // User-provided streams, for accessing and outputting data in ways SDL doesn't know about
+    // (decompressors, ring buffers, network streams etc.).
+    // Pass them by value to hand them over, or via std::ref() to keep them.
+    namespace meta
+    {
+        // A source of bytes. read() fills as much of the buffer as it can and returns
+        // how many bytes it wrote; zero means the end of the stream.
+        template <typename T>
+        concept source = requires(std::unwrap_reference_t<T>& s, std::span<std::byte> buf) {
+            { s.read(buf) } -> std::convertible_to<std::size_t>;
+        };
+
+        // A sink for bytes. write() returns how many bytes it consumed.
+        template <typename T>
+        concept sink = requires(std::unwrap_reference_t<T>& s, std::span<const std::byte> buf) {
+            { s.write(buf) } -> std::convertible_to<std::size_t>;
+        };
+
+        // Optionally, streams can be seekable. seek() returns the new position, or -1 on failure.
+        template <typename T>
+        concept seekable = requires(std::unwrap_reference_t<T>& s, i64 offset, seek_origin origin) {
+            { s.seek(offset, origin) } -> std::convertible_to<i64>;
+        };
+
+        // Optionally, streams can know their size.
+        template <typename T>
+        concept sized = requires(std::unwrap_reference_t<T>& s) {
+            { s.size() } -> std::convertible_to<i64>;
+        };
+    }
+
     namespace detail
     {
         // Base class for SDL_RWops operations.
@@ -41,12 +87,82 @@ namespace hal
         protected:
             using raii_object::raii_object;
         };
+
+        // Type-erased user stream. Unsupported operations fail.
+        class stream
+        {
+        public:
+            virtual ~stream() = default;
+
+            virtual std::size_t read(std::span<std::byte> buf);
+            virtual std::size_t write(std::span<const std::byte> buf);
+            virtual i64         seek(i64 offset, seek_origin origin);
+            virtual i64         size();
+        };
+
+        template <typename T>
+        class stream_model final : public stream
+        {
+        public:
+            stream_model(T s)
+                : m_stream { std::move(s) }
+            {
+            }
+
+            std::size_t read(std::span<std::byte> buf) override
+            {
+                if constexpr (meta::source<T>)
+                    return get().read(buf);
+                else
+                    return stream::read(buf);
+            }
+
+            std::size_t write(std::span<const std::byte> buf) override
+            {
+                if constexpr (meta::sink<T>)
+                    return get().write(buf);
+                else
+                    return stream::write(buf);
+            }
+
+            i64 seek(i64 offset, seek_origin origin) override
+            {
+                if constexpr (meta::seekable<T>)
+                    return get().seek(offset, origin);
+                else
+                    return stream::seek(offset, origin);
+            }
+
+            i64 size() override
+            {
+                if constexpr (meta::sized<T>)
+                    return get().size();
+                else
+                    return stream::size();
+            }
+
+        private:
+            std::unwrap_reference_t<T>& get()
+            {
+                return m_stream;
+            }
+
+            T m_stream;
+        };
+
+        // Create an RWops over a stream. Reads smaller than the read-ahead size are served
+        // from a buffer of that size; larger reads go straight into the caller's memory.
+        // Seeking works within the buffered data even if the stream itself isn't seekable,
+        // which is enough for image format detection.
+        SDL_RWops* make_rwops(std::unique_ptr<stream> s, std::size_t read_ahead);
     }
 
     // An abstraction of various methods of accessing data.
     class accessor : public detail::rwops
     {
     public:
+        static constexpr std::size_t default_read_ahead { 16 * 1024 };
+
         // Access a file.
         accessor(const char* path);
         accessor(std::nullptr_t) = delete;
@@ -54,6 +170,12 @@ namespace hal
         // Access a file.
         accessor(std::string_view path);
 
+        // Access a file by mapping it into memory, so that decoding reads straight from
+        // the page cache instead of through buffered reads. The mapping lives until the
+        // data is consumed. Falls back to regular file access for files that can't be mapped.
+        accessor(const char* path, HAL_TAG_NAME(mapped));
+        accessor(std::string_view path, HAL_TAG_NAME(mapped));
+
         // Access a buffer.
         template <std::size_t Size>
         accessor(std::span<const std::byte, Size> buffer)
@@ -61,6 +183,22 @@ namespace hal
         {
         }
 
+        // Access a user-provided stream, with a read-ahead buffer of a given size (zero for none).
+        // Decoders tend to issue many small reads, so unless the stream is buffered on its own,
+        // a read-ahead buffer saves a lot of calls into it.
+        template <meta::source S>
+        accessor(S src, std::size_t read_ahead = default_read_ahead)
+            : rwops { detail::make_rwops(std::make_unique<detail::stream_model<S>>(std::move(src)), read_ahead) }
+        {
+        }
+
+        // Access a standard input stream. It must outlive the accessor (until it's consumed).
+        // Standard streams are buffered already, so there's no read-ahead by default.
+        accessor(std::istream& str, std::size_t read_ahead = 0);
+
+        // [private] Compressed archive entries are decompressed into memory.
+        accessor(std::unique_ptr<std::byte[]> data, std::size_t size, pass_key<archive>);
+
         // get() functions seek the RWops back where they started.
         SDL_RWops* get(pass_key<image::context>) const; // Image format querying.
 
@@ -95,9 +233,25 @@ namespace hal
         {
         }
 
+        // Output to a user-provided stream. Writes go straight through.
+        // BMP saving needs the stream to be seekable.
+        template <meta::sink S>
+        outputter(S dst)
+            : rwops { detail::make_rwops(std::make_unique<detail::stream_model<S>>(std::move(dst)), 0) }
+        {
+        }
+
+        // Output to a standard output stream. It must outlive the outputter (until it's consumed).
+        outputter(std::ostream& str);
+
+        // Output to a memory buffer, replacing its contents.
+        // It must outlive the outputter (until it's consumed).
+        outputter(output_buffer& buf);
+
         // use() functions call release(), so the class gets "consumed".
         SDL_RWops* use(pass_key<view<const surface>>); // BMP saving.
         SDL_RWops* use(pass_key<image::context>);      // Image saving.
+        SDL_RWops* use(pass_key<archive>);             // Archive saving.
     };
 
     // Shorthand for creating a writeable byte span from a compatible array-like object.
@@ -10,9 +10,21 @@ namespace hal
     HAL_TAG(scale_width);
     HAL_TAG(scale_height);
 
+    // Filters used when resampling surfaces.
+    enum class filter : u8
+    {
+        nearest,
+        box,
+        bilinear,
+        bicubic,
+        lanczos3
+    };
+
     // A class that enables in-place scaling. This is desirable when creating
     // a surface and wanting to resize it immediately, such as:
     // font.render("Hello!").resize(hal::scale::width(128));
+    // Surfaces can also be resampled with a filter:
+    // surf.resize(hal::scale::mul(0.25f).filter(hal::filter::lanczos3));
     class scaler
     {
     public:
@@ -47,6 +59,19 @@ namespace hal
         {
         }
 
+        // Set the filter surfaces get resampled with.
+        constexpr scaler& filter(enum filter f)
+        {
+            m_filter = f;
+            return *this;
+        }
+
+        // Get the filter surfaces get resampled with.
+        constexpr enum filter filter() const
+        {
+            return m_filter;
+        }
+
         // Get the resulting point.
         constexpr point<val_t> operator()(point<val_t> src) const
         {
@@ -77,6 +102,11 @@ namespace hal
     private:
         type m_type;
 
+        enum filter m_filter
+        {
+            hal::filter::nearest
+        };
+
         union
         {
             val_t val;
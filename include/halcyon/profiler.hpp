@@ -0,0 +1,122 @@
+#pragma once
+
+// profiler.hpp:
+// Optional instrumentation of Halcyon's entry points.
+
+// Profiling is configured as such:
+//  - HAL_PROFILE_ENABLED enables profiling. It's off by default, even in debug builds;
+//    when disabled, every HAL_PROFILE_* macro expands to nothing.
+// Define it for Halcyon and your own code alike, or not at all.
+
+#ifdef HAL_PROFILE_ENABLED
+    #include <array>
+    #include <chrono>
+    #include <iosfwd>
+
+    #include <halcyon/types/numeric.hpp>
+
+    // For compatibility with MSVC.
+    #ifdef _MSC_VER
+        #define HAL_PROFILE_FUNCTION_NAME __FUNCSIG__
+    #else
+        #define HAL_PROFILE_FUNCTION_NAME __PRETTY_FUNCTION__
+    #endif
+#endif
+
+namespace hal
+{
+    namespace compile_settings
+    {
+        constexpr bool profile_enabled {
+#ifdef HAL_PROFILE_ENABLED
+            true
+#else
+            false
+#endif
+        };
+    }
+
+#ifdef HAL_PROFILE_ENABLED
+    namespace profiler
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Per-frame counters.
+        enum class counter : u8
+        {
+            draw_calls,
+            texture_uploads,
+            bytes_blitted,
+            glyphs_rasterized
+        };
+
+        constexpr std::size_t counter_count { 4 };
+
+        // Counter values accumulated over a single frame.
+        struct frame_stats
+        {
+            clock::time_point                 end;
+            std::array<u64, counter_count> counters {};
+
+            u64 operator[](counter c) const
+            {
+                return counters[static_cast<std::size_t>(c)];
+            }
+        };
+
+        // Measures the time between its construction and destruction.
+        // Zones are recorded into a ring buffer owned by the current thread, so recording
+        // takes no locks; if the buffer is full (nobody's calling write_trace()),
+        // the zone is dropped instead.
+        class zone
+        {
+        public:
+            // The name must outlive the profiler - use string literals.
+            zone(const char* name);
+            ~zone();
+
+            zone(const zone&)            = delete;
+            zone& operator=(const zone&) = delete;
+
+        private:
+            const char*       m_name;
+            clock::time_point m_begin;
+        };
+
+        // Add to a counter of the current frame.
+        void count(counter c, u64 amount = 1);
+
+        // Mark the end of a frame. Called by renderer::present().
+        void frame();
+
+        // Counter values of the last finished frame.
+        frame_stats last_frame();
+
+        // Move all recorded zones and frames out of their buffers and write them as
+        // Chrome trace event JSON, viewable in chrome://tracing or Perfetto.
+        void write_trace(std::ostream& str);
+
+        // The amount of zones dropped due to full buffers.
+        u64 dropped();
+    }
+#endif
+}
+
+#ifdef HAL_PROFILE_ENABLED
+
+    #define HAL_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define HAL_PROFILE_CONCAT(a, b)      HAL_PROFILE_CONCAT_IMPL(a, b)
+
+    #define HAL_PROFILE_ZONE(name)      const ::hal::profiler::zone HAL_PROFILE_CONCAT(hal_profile_zone_, __LINE__) { name }
+    #define HAL_PROFILE_FUNCTION()      HAL_PROFILE_ZONE(HAL_PROFILE_FUNCTION_NAME)
+    #define HAL_PROFILE_COUNT(ctr, amt) ::hal::profiler::count(::hal::profiler::counter::ctr, amt)
+    #define HAL_PROFILE_FRAME()         ::hal::profiler::frame()
+
+#else
+
+    #define HAL_PROFILE_ZONE(...)     (static_cast<void>(0))
+    #define HAL_PROFILE_FUNCTION()    (static_cast<void>(0))
+    #define HAL_PROFILE_COUNT(...)    (static_cast<void>(0))
+    #define HAL_PROFILE_FRAME()       (static_cast<void>(0))
+
+#endif
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <span>
 
 #include <SDL_surface.h>
 
 #include <halcyon/internal/drawer.hpp>
+#include <halcyon/internal/kernels.hpp>
 #include <halcyon/internal/raii_object.hpp>
 #include <halcyon/internal/rwops.hpp>
 #include <halcyon/internal/scaler.hpp>
@@ -25,6 +27,7 @@ namespace hal
     class pixel_reference;
     class blitter;
     class window;
+    class thread_pool;
 
     namespace image
     {
@@ -37,6 +40,15 @@ namespace hal
         class font_glyph;
     }
 
+    // A color channel, as used by view<surface>::swizzle().
+    enum class channel : u8
+    {
+        r,
+        g,
+        b,
+        a
+    };
+
     template <>
     class view<const surface> : public detail::view_base<SDL_Surface>
     {
@@ -58,6 +70,10 @@ namespace hal
         // Use with text.
         [[nodiscard]] surface convert(pixel::format fmt) const;
 
+        // Convert this surface in row bands on a thread pool.
+        // Paletted and color-keyed surfaces fall back to the single-threaded version.
+        [[nodiscard]] surface convert(pixel::format fmt, thread_pool& pool) const;
+
         // Get surface dimensions.
         pixel::point size() const;
 
@@ -70,11 +86,26 @@ namespace hal
 
         color::value_t alpha_mod() const;
 
-        // Get a resized copy of the surface. Useful for saving
-        // memory after converting to a texture.
+        // Get a resized copy of the surface in the default format. Useful for saving
+        // memory after converting to a texture. Nearest-neighbour copies pixels as-is (no blending).
+        // Scalers with a filter other than nearest are resampled.
         surface resize(pixel::point sz) const;
         surface resize(scaler scl) const;
 
+        // Get a resized copy of the surface, scaled in row bands on a thread pool.
+        // The result is the same as without a pool.
+        surface resize(pixel::point sz, thread_pool& pool) const;
+        surface resize(scaler scl, thread_pool& pool) const;
+
+        // Get a resampled copy of the surface in the default format.
+        // Slower than nearest-neighbour, but much better-looking, especially when downscaling.
+        surface resize(pixel::point sz, enum filter f) const;
+        surface resize(pixel::point sz, enum filter f, thread_pool& pool) const;
+
+        // Split the surface into row bands and run a function over each one on a thread pool.
+        // The function receives a band's first row and one past its last row.
+        void for_each_band(thread_pool& pool, const std::function<void(pixel_t begin, pixel_t end)>& func) const;
+
         // Get pixel at position.
         // This functionality is exclusive to surfaces, as textures
         // are extremely slow to retrieve pixel information.
@@ -98,6 +129,9 @@ namespace hal
         // Fill an array of rectangles with a color.
         void fill(std::span<const pixel::rect> areas, color clr);
 
+        // Fill the entire surface with a color, in row bands on a thread pool.
+        void fill(color clr, thread_pool& pool);
+
         // Get/set this surface's blend mode.
         using super::blend;
         void blend(blend_mode bm);
@@ -110,6 +144,42 @@ namespace hal
         using super::alpha_mod;
         void alpha_mod(color::value_t val);
 
+        // Bulk pixel operations. These require a 32-bit format with an alpha channel
+        // (rgba32, argb32, bgra32 etc.) and use SSE2/AVX2 where the CPU supports it.
+
+        // Invert color channels. Alpha is left intact.
+        void invert();
+
+        // Multiply every channel, including alpha, by a color.
+        void multiply(color c);
+
+        // Multiply color channels by alpha.
+        void premultiply();
+
+        // Replace color channels with luma. Alpha is left intact.
+        void grayscale();
+
+        // Rearrange channels. Each parameter names the source channel for that destination
+        // channel, i.e. swizzle(channel::b, channel::g, channel::r, channel::a) swaps red and blue.
+        void swizzle(channel r, channel g, channel b, channel a);
+
+        // Replace every pixel with the result of a function taking and returning a color.
+        // Much faster than going through operator[], but not vectorized.
+        template <std::invocable<color> F>
+        void transform(F func)
+        {
+            const detail::kernels::image img { detail::kernels::image_of(get()) };
+
+            for (pixel_t y { 0 }; y < img.size.y; ++y)
+            {
+                u32* const row { img.row(y) };
+
+                for (pixel_t x { 0 }; x < img.size.x; ++x)
+                    row[x] = img.fmt.pack(func(img.fmt.unpack(row[x])));
+            }
+        }
+
+        using super::operator[];
         pixel_reference operator[](pixel::point pt);
     };
 
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include <halcyon/surface.hpp>
+
+// surface_view.hpp:
+// Typed, row-based access to a surface's pixels with a compile-time format.
+
+namespace hal
+{
+    namespace pixel
+    {
+        // Byte-ordered pixel types. Members are in memory order, so these are
+        // correct regardless of the platform's endianness.
+
+        struct rgba32_t
+        {
+            u8 r, g, b, a;
+
+            constexpr operator color() const { return { r, g, b, a }; }
+            constexpr static rgba32_t from(color c) { return { c.r, c.g, c.b, c.a }; }
+        };
+
+        struct argb32_t
+        {
+            u8 a, r, g, b;
+
+            constexpr operator color() const { return { r, g, b, a }; }
+            constexpr static argb32_t from(color c) { return { c.a, c.r, c.g, c.b }; }
+        };
+
+        struct bgra32_t
+        {
+            u8 b, g, r, a;
+
+            constexpr operator color() const { return { r, g, b, a }; }
+            constexpr static bgra32_t from(color c) { return { c.b, c.g, c.r, c.a }; }
+        };
+
+        struct abgr32_t
+        {
+            u8 a, b, g, r;
+
+            constexpr operator color() const { return { r, g, b, a }; }
+            constexpr static abgr32_t from(color c) { return { c.a, c.b, c.g, c.r }; }
+        };
+
+        struct rgb24_t
+        {
+            u8 r, g, b;
+
+            constexpr operator color() const { return { r, g, b }; }
+            constexpr static rgb24_t from(color c) { return { c.r, c.g, c.b }; }
+        };
+
+        struct bgr24_t
+        {
+            u8 b, g, r;
+
+            constexpr operator color() const { return { r, g, b }; }
+            constexpr static bgr24_t from(color c) { return { c.b, c.g, c.r }; }
+        };
+
+        static_assert(sizeof(rgba32_t) == 4 && sizeof(argb32_t) == 4 && sizeof(bgra32_t) == 4 && sizeof(abgr32_t) == 4);
+        static_assert(sizeof(rgb24_t) == 3 && sizeof(bgr24_t) == 3);
+    }
+
+    namespace detail
+    {
+        // The type a single pixel of a format is stored as. Byte-ordered formats get
+        // a struct with named channels; packed formats get an unsigned integer of their size.
+        template <pixel::format Format>
+        consteval auto pixel_type_of()
+        {
+            using enum pixel::format;
+
+            if constexpr (Format == rgba32)
+                return std::type_identity<pixel::rgba32_t> {};
+
+            else if constexpr (Format == argb32)
+                return std::type_identity<pixel::argb32_t> {};
+
+            else if constexpr (Format == bgra32)
+                return std::type_identity<pixel::bgra32_t> {};
+
+            else if constexpr (Format == abgr32)
+                return std::type_identity<pixel::abgr32_t> {};
+
+            else if constexpr (Format == rgb24)
+                return std::type_identity<pixel::rgb24_t> {};
+
+            else if constexpr (Format == bgr24)
+                return std::type_identity<pixel::bgr24_t> {};
+
+            else if constexpr (SDL_BYTESPERPIXEL(std::to_underlying(Format)) == 4)
+                return std::type_identity<u32> {};
+
+            else if constexpr (SDL_BYTESPERPIXEL(std::to_underlying(Format)) == 2)
+                return std::type_identity<u16> {};
+
+            else
+            {
+                static_assert(SDL_BYTESPERPIXEL(std::to_underlying(Format)) == 1, "Unsupported pixel format");
+                return std::type_identity<u8> {};
+            }
+        }
+    }
+
+    // A view of a surface's pixels, with its format known at compile time.
+    // Every row is a contiguous std::span of pixels, so loops over it need neither format
+    // lookups nor SDL calls and can be vectorized. Works with ranges algorithms; for
+    // parallel algorithms, use pixels() (or parallelize over row indices).
+    // Like other views, this doesn't own the surface, so make sure it stays alive.
+    template <pixel::format Format>
+    class surface_view
+    {
+    public:
+        using pixel_type = typename decltype(detail::pixel_type_of<Format>())::type;
+
+        surface_view() = default;
+
+        surface_view(view<surface> surf)
+            : m_pixels { static_cast<std::byte*>(surf.get()->pixels) }
+            , m_pitch { surf.get()->pitch }
+            , m_size { surf.size() }
+        {
+            HAL_ASSERT(surf.pixel_format() == Format, "Surface format mismatch (desired ", Format, ", actually ", surf.pixel_format(), ')');
+            HAL_ASSERT(!SDL_MUSTLOCK(surf.get()), "Typed views don't support RLE surfaces");
+        }
+
+        // Get a row of pixels.
+        std::span<pixel_type> row(pixel_t y) const
+        {
+            HAL_ASSERT(y >= 0 && y < m_size.y, "Out-of-range row");
+
+            return { reinterpret_cast<pixel_type*>(m_pixels + y * m_pitch), static_cast<std::size_t>(m_size.x) };
+        }
+
+        // Get all rows, as a range of spans.
+        auto rows() const
+        {
+            // Capture by value, so that the range doesn't depend on this view's lifetime.
+            const auto row_at = [pixels = m_pixels, pitch = m_pitch, width = static_cast<std::size_t>(m_size.x)](pixel_t y)
+            {
+                return std::span<pixel_type> { reinterpret_cast<pixel_type*>(pixels + y * pitch), width };
+            };
+
+            return std::views::iota(pixel_t { 0 }, m_size.y) | std::views::transform(row_at);
+        }
+
+        // Whether rows have no padding between them, making pixels() usable.
+        bool contiguous() const
+        {
+            return m_pitch == static_cast<int>(m_size.x * sizeof(pixel_type));
+        }
+
+        // Get all pixels as a single span.
+        // Only valid if the view is contiguous.
+        std::span<pixel_type> pixels() const
+        {
+            HAL_ASSERT(contiguous(), "Surface rows are padded");
+
+            return { reinterpret_cast<pixel_type*>(m_pixels), static_cast<std::size_t>(m_size.x) * m_size.y };
+        }
+
+        // Access a single pixel.
+        pixel_type& operator[](pixel::point pos) const
+        {
+            HAL_ASSERT(pos.x >= 0 && pos.x < m_size.x, "Out-of-range width");
+
+            return row(pos.y)[pos.x];
+        }
+
+        pixel::point size() const
+        {
+            return m_size;
+        }
+
+    private:
+        std::byte*   m_pixels { nullptr };
+        int          m_pitch { 0 };
+        pixel::point m_size { 0, 0 };
+    };
+}
\ No newline at end of file
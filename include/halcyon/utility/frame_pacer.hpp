@@ -0,0 +1,112 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <halcyon/utility/timer.hpp>
+
+// utility/frame_pacer.hpp:
+// Frame rate limiting, fixed-timestep updates and frame time statistics.
+
+namespace hal
+{
+    // Frame times, counted into fixed-width buckets.
+    // The last bucket also holds everything longer than the histogram's range.
+    class frame_histogram
+    {
+    public:
+        using duration = std::chrono::nanoseconds;
+
+        // Create a histogram with a given bucket width and count (0 - 64ms by default).
+        frame_histogram(duration width = std::chrono::microseconds { 500 }, std::size_t buckets = 128);
+
+        void add(duration frame);
+        void clear();
+
+        // The frame time below which a given fraction [0, 1] of frames lie,
+        // rounded up to the nearest bucket boundary.
+        duration percentile(f64 frac) const;
+
+        // Shortest, longest and average recorded frame time.
+        duration min() const;
+        duration max() const;
+        duration mean() const;
+
+        std::span<const u32> buckets() const;
+        duration             bucket_width() const;
+
+        // The amount of recorded frames.
+        std::size_t count() const;
+
+    private:
+        std::vector<u32> m_buckets;
+        duration         m_width;
+
+        duration    m_min { duration::max() }, m_max { duration::zero() }, m_total { duration::zero() };
+        std::size_t m_count { 0 };
+    };
+
+    // Keeps a loop running at a target frame rate and drives fixed-timestep updates.
+    // Waiting is done by sleeping until shortly before the deadline, then spinning for the
+    // rest; OS sleeps tend to overshoot, and spinning for the last stretch keeps jitter low.
+    // A typical loop:
+    //     pacer.tick();
+    //     while (pacer.step()) update(pacer.step_size());
+    //     draw(pacer.alpha());
+    //     rnd.present(hal::tag::no_clear); // If the frame gets fully overdrawn anyway.
+    class frame_pacer
+    {
+    public:
+        using clock    = timer::clock;
+        using duration = std::chrono::nanoseconds;
+
+        // Create a pacer with a target frame rate. Zero means no limit.
+        frame_pacer(f64 fps = 0.0);
+
+        // Wait until the current frame's deadline (if there's a target frame rate),
+        // then start a new frame. Returns the previous frame's length in seconds.
+        f64 tick();
+
+        // Whether a fixed update is due. Call in a loop after tick();
+        // every true consumes one step's worth of accumulated time.
+        bool step();
+
+        // How far between two fixed updates the current frame is, in [0, 1).
+        // Use it to interpolate between the previous and current state when drawing.
+        f64 alpha() const;
+
+        // Get/set the target frame rate. Zero means no limit.
+        f64  target_fps() const;
+        void target_fps(f64 fps);
+
+        // Get/set the fixed update step, in seconds.
+        f64  step_size() const;
+        void step_size(f64 secs);
+
+        // Get/set the most fixed updates run per frame. Time beyond that is dropped,
+        // so that a slow update can't make every following frame even slower.
+        u32  max_steps() const;
+        void max_steps(u32 steps);
+
+        // Get/set how long before the deadline sleeping gives way to spinning.
+        duration spin_threshold() const;
+        void     spin_threshold(duration dur);
+
+        const frame_histogram& histogram() const;
+        frame_histogram&       histogram();
+
+    private:
+        void wait();
+
+        timer             m_frame;
+        clock::time_point m_deadline;
+        duration          m_period { duration::zero() };
+        duration          m_spin { std::chrono::milliseconds { 2 } };
+
+        f64 m_step { 1.0 / 60.0 };
+        f64 m_accumulator { 0.0 };
+        u32 m_max_steps { 8 };
+
+        frame_histogram m_histogram;
+    };
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <halcyon/types/color.hpp>
 #include <halcyon/video/types.hpp>
 
@@ -70,13 +72,14 @@ namespace hal
         public:
             target(T& obj, target_texture& tex)
                 : m_ref { obj }
+                , m_old { obj.target() }
             {
                 set(tex);
             }
 
             ~target()
             {
-                m_ref.reset_target();
+                m_ref.target(m_old);
             }
 
             void set(target_texture& c)
@@ -86,6 +89,8 @@ namespace hal
 
         private:
             T& m_ref;
+
+            decltype(std::declval<T&>().target()) m_old;
         };
     }
 }
\ No newline at end of file
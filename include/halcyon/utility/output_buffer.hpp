@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <halcyon/internal/rwops.hpp>
+
+// utility/output_buffer.hpp:
+// Growable in-memory output.
+
+namespace hal
+{
+    // A growable in-memory target for outputters, for encoding images etc. without touching
+    // the disk. Clearing keeps the allocation, so a buffer that's reused across saves stops
+    // allocating once it has grown large enough. Pass it to an outputter directly; see also
+    // output_buffer::pool for sharing buffers between threads.
+    class output_buffer
+    {
+    public:
+        class pool;
+
+        output_buffer() = default;
+
+        output_buffer(std::size_t capacity);
+
+        // Sink interface for outputters.
+        std::size_t write(std::span<const std::byte> src);
+        i64         seek(i64 offset, seek_origin origin);
+
+        // Get the output so far.
+        std::span<const std::byte> data() const;
+
+        std::size_t size() const;
+        std::size_t capacity() const;
+
+        void reserve(std::size_t capacity);
+
+        // Discard the output, but keep the allocation.
+        void clear();
+
+    private:
+        std::vector<std::byte> m_data;
+        std::size_t            m_pos { 0 };
+    };
+
+    // Hands out output buffers and takes them back once they're done with, so that
+    // allocations are reused across saves, even when those happen on different threads.
+    class output_buffer::pool
+    {
+    public:
+        // Exclusive use of a pooled buffer. The buffer goes back to the pool on destruction.
+        class lease
+        {
+        public:
+            // [private] Leases are obtained with pool::acquire().
+            lease(pool& p, std::unique_ptr<output_buffer> buf, pass_key<pool>);
+
+            lease(const lease&) = delete;
+            lease(lease&&)      = default;
+
+            ~lease();
+
+            output_buffer& operator*() const;
+            output_buffer* operator->() const;
+
+        private:
+            pool*                          m_pool;
+            std::unique_ptr<output_buffer> m_buffer;
+        };
+
+        pool() = default;
+
+        pool(const pool&) = delete;
+
+        // Get an empty buffer. Reuses a returned one if there is any.
+        [[nodiscard]] lease acquire();
+
+        // Get the amount of buffers waiting to be reused.
+        std::size_t available() const;
+
+    private:
+        void put_back(std::unique_ptr<output_buffer> buf);
+
+        mutable std::mutex                          m_mutex;
+        std::vector<std::unique_ptr<output_buffer>> m_free;
+    };
+}
\ No newline at end of file
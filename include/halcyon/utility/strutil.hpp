@@ -2,6 +2,7 @@
 
 #include <iomanip>
 #include <sstream>
+#include <string_view>
 
 #include <halcyon/utility/concepts.hpp>
 
@@ -14,6 +15,11 @@ namespace hal
     bool streq(const char* lhs, const char* rhs);
     bool streq(const wchar_t* lhs, const wchar_t* rhs);
 
+    // Decode the first UTF-8 code point of a string and remove it from the view.
+    // Malformed sequences decode as U+FFFD, one byte at a time. That includes truncated and
+    // overlong sequences, UTF-16 surrogates and anything past U+10FFFF.
+    char32_t pop_codepoint(std::string_view& str);
+
     // Input all arguments into a stringstream and return them as a string.
     template <typename... Args>
     std::string string_from_pack(Args&&... args)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// utility/thread_pool.hpp:
+// A fixed set of worker threads for parallel processing.
+
+namespace hal
+{
+    // A simple FIFO thread pool. The calling thread takes part in parallel_for(),
+    // so a pool with zero workers is valid and simply runs everything inline.
+    // Don't call parallel_for() from inside a pool task - it waits on the same workers.
+    class thread_pool
+    {
+    public:
+        using task = std::move_only_function<void()>;
+
+        // One worker per hardware thread, minus the calling one.
+        static std::size_t default_workers();
+
+        // Create a pool with a number of worker threads.
+        thread_pool(std::size_t workers = default_workers());
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool(thread_pool&&)      = delete;
+
+        // Finishes all queued tasks before joining the workers.
+        ~thread_pool();
+
+        // Queue a task. Runs it immediately if there are no workers.
+        void submit(task t);
+
+        // Split [0, count) into chunks of (at most) a given size and run a function
+        // over each one, in parallel. Returns once all chunks are processed.
+        void parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t begin, std::size_t end)>& func);
+
+        // The amount of threads taking part in parallel_for(), including the calling one.
+        std::size_t concurrency() const;
+
+    private:
+        void work();
+
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        std::deque<task>        m_tasks;
+        bool                    m_stop { false };
+
+        std::vector<std::jthread> m_threads;
+    };
+}
\ No newline at end of file
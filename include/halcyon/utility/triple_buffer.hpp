@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <halcyon/types/numeric.hpp>
+
+// utility/triple_buffer.hpp:
+// Lock-free hand-off of whole values from one thread to another.
+
+namespace hal
+{
+    // Three copies of a value: one being written, one being read, and the latest published
+    // one in between. The writer and the reader each only ever swap their own copy with the
+    // middle one, so neither ever waits for the other, and the reader always sees a whole value.
+    // Meant for a single writer and a single reader thread; intermediate values are skipped if
+    // the writer publishes faster than the reader reads.
+    template <typename T>
+    class triple_buffer
+    {
+    public:
+        triple_buffer() = default;
+
+        triple_buffer(const T& init)
+            : m_buffers { init, init, init }
+        {
+        }
+
+        triple_buffer(const triple_buffer&) = delete;
+
+        // [Writer] The copy to fill in before publishing.
+        T& back()
+        {
+            return m_buffers[m_back];
+        }
+
+        // [Writer] Make the back copy the latest value, and get a new back copy.
+        // Note that the new back copy holds an older value, not the published one.
+        void publish()
+        {
+            m_back = m_middle.exchange(m_back | fresh, std::memory_order_acq_rel) & index;
+        }
+
+        // [Reader] Get the latest published value. The reference stays valid (and unchanging)
+        // until the next call to read().
+        const T& read()
+        {
+            if (m_middle.load(std::memory_order_relaxed) & fresh)
+                m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & index;
+
+            return m_buffers[m_front];
+        }
+
+    private:
+        static constexpr u8 index { 0b011 }, fresh { 0b100 };
+
+        std::array<T, 3> m_buffers {};
+
+        // Kept apart, so that the writer and the reader don't share a cache line.
+        alignas(64) u8 m_back { 0 };
+        alignas(64) std::atomic<u8> m_middle { 1 };
+        alignas(64) u8 m_front { 2 };
+    };
+}
\ No newline at end of file
@@ -4,14 +4,23 @@
 
 #include <halcyon/image.hpp>
 #include <halcyon/surface.hpp>
+#include <halcyon/surface_view.hpp>
 #include <halcyon/ttf.hpp>
 
 #include <halcyon/events.hpp>
 
+#include <halcyon/video/atlas.hpp>
+#include <halcyon/video/command_buffer.hpp>
 #include <halcyon/video/display.hpp>
 #include <halcyon/video/driver.hpp>
+#include <halcyon/video/glyph_cache.hpp>
+#include <halcyon/video/mesh.hpp>
 #include <halcyon/video/message_box.hpp>
+#include <halcyon/video/primitive_batch.hpp>
+#include <halcyon/video/render_queue.hpp>
 #include <halcyon/video/renderer.hpp>
+#include <halcyon/video/sprite_batch.hpp>
+#include <halcyon/video/upload_queue.hpp>
 #include <halcyon/video/window.hpp>
 
 #include <halcyon/internal/string.hpp>
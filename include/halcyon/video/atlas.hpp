@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+
+#include <halcyon/internal/packer.hpp>
+
+#include <halcyon/video/renderer.hpp>
+#include <halcyon/video/texture.hpp>
+
+#include <halcyon/surface.hpp>
+
+// video/atlas.hpp:
+// Many small images packed into a few large textures.
+
+namespace hal
+{
+    class atlas_builder;
+
+    // A set of texture pages with many images packed into them.
+    // Draw an image by rendering its page with the image's area as the source:
+    // rnd.render(atl.page(e.page)).from(e.area)(), where e = atl[id].
+    class atlas
+    {
+    public:
+        using id_t = u32;
+
+        // A packed image's location.
+        struct entry
+        {
+            u32         page;
+            pixel::rect area;
+        };
+
+        atlas() = default;
+
+        // [private] Atlases are created with atlas_builder::operator().
+        atlas(std::vector<static_texture>&& pages, std::vector<entry>&& entries, pass_key<atlas_builder>);
+
+        // Get an image's location. IDs are those returned by atlas_builder::add().
+        const entry& operator[](id_t id) const;
+
+        // Get a page's texture.
+        view<const texture> page(u32 idx) const;
+
+        // The amount of pages.
+        u32 pages() const;
+
+        // The amount of packed images.
+        std::size_t size() const;
+
+    private:
+        std::vector<static_texture> m_pages;
+        std::vector<entry>          m_entries;
+    };
+
+    // Collects surfaces and packs them into atlas pages.
+    // Images are sorted by height and placed with a skyline packer,
+    // overflowing into new pages as needed. Surfaces are only referenced,
+    // so they have to stay alive until the atlas is built.
+    class atlas_builder
+    {
+    public:
+        // Page size must not exceed the renderer's maximum texture size.
+        // Padding is left around each image to prevent filtering from bleeding into neighbours.
+        atlas_builder(pixel::point page_size = { 2048, 2048 }, pixel_t padding = 1);
+
+        // Queue a surface for packing and get its ID in the resulting atlas.
+        // The surface must not be empty.
+        atlas::id_t add(view<const surface> surf);
+
+        // Pack all queued surfaces and upload the pages.
+        [[nodiscard]] atlas operator()(view<renderer> rnd) const;
+
+        // The amount of queued surfaces.
+        std::size_t size() const;
+
+    private:
+        std::vector<view<const surface>> m_sources;
+
+        pixel::point m_pageSize;
+        pixel_t      m_padding;
+    };
+}
\ No newline at end of file
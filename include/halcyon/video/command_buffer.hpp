@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+
+#include <halcyon/video/renderer.hpp>
+
+// video/command_buffer.hpp:
+// Rendering commands recorded on any thread and replayed on the render thread.
+
+namespace hal
+{
+    class command_buffer;
+
+    // A builder for a recorded texture copy. Works like a copyer,
+    // except that finishing the operation only records it.
+    class recorded_copyer : public detail::drawer<const texture, coord_t, renderer, recorded_copyer>
+    {
+    public:
+        // [private] Copies are recorded with command_buffer::render().
+        recorded_copyer(command_buffer& buf, view<const texture> tex, pass_key<command_buffer>);
+
+        // Set the texture's rotation.
+        [[nodiscard]] recorded_copyer& rotate(f64 angle);
+
+        // Set the texture's flip.
+        [[nodiscard]] recorded_copyer& flip(enum flip f);
+
+        // Record the copy.
+        void operator()();
+
+    private:
+        command_buffer& m_buffer;
+
+        f64 m_angle { 0.0 };
+
+        enum flip m_flip
+        {
+            flip::none
+        };
+    };
+
+    // A compact stream of rendering commands. Renderers may only be used from the thread
+    // that created them, so scene traversal can't otherwise be split among threads.
+    // Instead, each thread records its part of the frame into its own buffer, and the render
+    // thread replays the buffers in order. A single buffer must not be recorded to from multiple
+    // threads at once; textures and targets referenced by a buffer must outlive its replay.
+    class command_buffer
+    {
+    public:
+        command_buffer() = default;
+
+        // Record clearing the render target with the current draw color.
+        void clear();
+
+        // Record drawing a single point with the current color.
+        void draw(coord::point pt);
+
+        // Record drawing a line with the current color.
+        void draw(coord::point from, coord::point to);
+
+        // Record outlining a rectangle with the current color.
+        void draw(const coord::rect& area);
+
+        // Record filling a rectangle with the current color.
+        void fill(const coord::rect& area);
+
+        // Record filling the entire render target with the current color.
+        void fill();
+
+        // Record setting the draw color.
+        void color(hal::color clr);
+
+        // Record setting the blend mode.
+        void blend(blend_mode bm);
+
+        // Record setting the render target.
+        void target(target_texture& tx);
+
+        // Record resetting the render target.
+        void reset_target();
+
+        // Record a texture copy via a builder.
+        [[nodiscard]] recorded_copyer render(view<const texture> tex);
+
+        // Record a texture copy directly.
+        // An unset source (x == max) means the entire texture, an unset destination means the entire target.
+        void copy(view<const texture> tex, const pixel::rect& src, const coord::rect& dst, f64 angle = 0.0, enum flip f = flip::none);
+
+        // Execute all recorded commands on a renderer, in order. Must be called from the render thread.
+        // The buffer is left as-is, so it can be replayed again.
+        void replay(view<renderer> rnd) const;
+
+        // Discard all recorded commands, keeping the allocated memory.
+        void reset();
+
+        // Preallocate space for a number of bytes' worth of commands.
+        void reserve(std::size_t bytes);
+
+        // The amount of recorded commands.
+        std::size_t size() const;
+
+        bool empty() const;
+
+    private:
+        enum class op : u8
+        {
+            clear,
+            point,
+            line,
+            outline,
+            fill_rect,
+            fill,
+            color,
+            blend,
+            target,
+            reset_target,
+            copy
+        };
+
+        // Append a command with its (trivially copyable) arguments.
+        template <typename T>
+        void push(op o, const T& args);
+
+        void push(op o);
+
+        std::vector<std::byte> m_data;
+        std::size_t            m_count { 0 };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <halcyon/internal/packer.hpp>
+
+#include <halcyon/video/sprite_batch.hpp>
+#include <halcyon/video/texture.hpp>
+
+#include <halcyon/ttf.hpp>
+
+// video/glyph_cache.hpp:
+// Text drawn from rasterized glyphs kept in texture pages.
+
+namespace hal
+{
+    class glyph_cache;
+
+    // A builder for drawing text through a glyph cache.
+    class cached_text
+    {
+    public:
+        // [private] Cached text is drawn with glyph_cache::draw().
+        cached_text(glyph_cache& cache, view<const font> fnt, std::string_view text, pass_key<glyph_cache>);
+
+        // Set the foreground (text) color.
+        [[nodiscard]] cached_text& fg(color c);
+
+        // Set the background color.
+        // Does not have an effect on all render types.
+        [[nodiscard]] cached_text& bg(color c);
+
+        // Set the render type.
+        [[nodiscard]] cached_text& type(font::render_type rt);
+
+        // Set the top-left corner of the first line.
+        [[nodiscard]] cached_text& to(coord::point pos);
+
+        // Draw the text.
+        void operator()();
+
+    private:
+        glyph_cache& m_cache;
+
+        view<const font> m_font;
+        std::string_view m_text;
+
+        coord::point m_pos { 0.0f, 0.0f };
+
+        color m_fg { palette::white }, m_bg { palette::transparent };
+
+        font::render_type m_type { font::default_render_type };
+    };
+
+    // A cache of glyphs rasterized by SDL_ttf, keyed on font, code point, render type and colors.
+    // Glyphs are rasterized and uploaded only once, on first use, into atlas pages; after that,
+    // text is drawn purely from cached metrics as batched quads - one geometry call per page used.
+    // Fonts must outlive the cache (or the cache has to be cleared before they're destroyed).
+    class glyph_cache
+    {
+    public:
+        // A cached glyph's location and metrics.
+        struct glyph
+        {
+            u32         page;
+            pixel::rect area;
+            pixel_t     advance;
+        };
+
+        glyph_cache() = default;
+
+        // Page size must not exceed the renderer's maximum texture size.
+        glyph_cache(view<renderer> rnd, pixel::point page_size = { 1024, 1024 });
+
+        // Start building text. Newlines move the pen to the start of the next line.
+        [[nodiscard]] cached_text draw(view<const font> fnt, std::string_view text);
+
+        // Draw text directly.
+        void draw(view<const font> fnt, std::string_view text, coord::point pos, font::render_type rt = font::default_render_type, color fg = palette::white, color bg = palette::transparent);
+
+        // Get a glyph, rasterizing and uploading it if it isn't cached yet.
+        const glyph& get(view<const font> fnt, char32_t ch, font::render_type rt = font::default_render_type, color fg = palette::white, color bg = palette::transparent);
+
+        // The size text would have if drawn with this cache.
+        pixel::point size_text(view<const font> fnt, std::string_view text, font::render_type rt = font::default_render_type);
+
+        // Forget all cached glyphs. Pages are kept and reused.
+        void clear();
+
+        // The amount of cached glyphs.
+        std::size_t size() const;
+
+        // The amount of allocated pages.
+        u32 pages() const;
+
+    private:
+        struct key
+        {
+            TTF_Font*         fnt;
+            char32_t          ch;
+            font::render_type type;
+            color             fg, bg;
+
+            bool operator==(const key& other) const = default;
+        };
+
+        struct key_hash
+        {
+            std::size_t operator()(const key& k) const;
+        };
+
+        // Allocate a new, cleared page.
+        void add_page();
+
+        view<renderer> m_rnd;
+        pixel::point   m_pageSize;
+
+        std::vector<target_texture>  m_pages;
+        std::vector<detail::skyline> m_packers;
+        std::vector<sprite_batch>    m_batches;
+
+        std::unordered_map<key, glyph, key_hash> m_glyphs;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <halcyon/types/color.hpp>
+#include <halcyon/video/types.hpp>
+
+// video/mesh.hpp:
+// Indexed triangle meshes with per-vertex colors and texture coordinates.
+
+namespace hal
+{
+    // A triangle mesh, drawn with a single call via renderer::draw().
+    // Vertex attributes are stored as separate arrays (structure-of-arrays), so updating just
+    // positions (or just colors) touches nothing else. Spans returned by the accessors can be
+    // written to directly, but are invalidated by anything that resizes the mesh.
+    // Texture coordinates are normalized: (0, 0) is the top left, (1, 1) is the bottom right.
+    // Without indices, every three vertices make up a triangle.
+    class mesh
+    {
+    public:
+        using index_t = int;
+
+        mesh() = default;
+
+        // Create a mesh with a number of vertices at (0, 0), colored white.
+        mesh(std::size_t vertices);
+
+        // Add a vertex and get its index.
+        index_t push(coord::point pos, color c = palette::white, coord::point uv = { 0.0f, 0.0f });
+
+        // Add a triangle's indices.
+        void push(index_t a, index_t b, index_t c);
+
+        // Add a quad's indices (two triangles), clockwise from the top left.
+        void push(index_t a, index_t b, index_t c, index_t d);
+
+        // Change the vertex count. New vertices are at (0, 0), colored white.
+        void resize(std::size_t vertices);
+
+        // Change the index count. New indices are zero.
+        void resize_indices(std::size_t count);
+
+        // Preallocate space for vertices and indices.
+        void reserve(std::size_t vertices, std::size_t indices);
+
+        // Remove all vertices and indices.
+        void clear();
+
+        std::span<coord::point>       positions();
+        std::span<const coord::point> positions() const;
+
+        std::span<color>       colors();
+        std::span<const color> colors() const;
+
+        std::span<coord::point>       uvs();
+        std::span<const coord::point> uvs() const;
+
+        std::span<index_t>       indices();
+        std::span<const index_t> indices() const;
+
+        // The amount of vertices.
+        std::size_t size() const;
+
+    private:
+        std::vector<coord::point> m_positions;
+        std::vector<color>        m_colors;
+        std::vector<coord::point> m_uvs;
+
+        std::vector<index_t> m_indices;
+    };
+}
\ No newline at end of file
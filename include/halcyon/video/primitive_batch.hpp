@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include <halcyon/video/renderer.hpp>
+
+// video/primitive_batch.hpp:
+// Many colored shapes, submitted in one go.
+
+namespace hal
+{
+    // An immediate-mode accumulator for points, lines and rectangles, each with its own color.
+    // Every shape becomes a quad (lines are a pixel wide), so everything is drawn with a single
+    // SDL_RenderGeometry call, blended with the renderer's blend mode. Meant for debug overlays,
+    // particles and such: queue shapes during the frame, then flush once.
+    class primitive_batch
+    {
+    public:
+        primitive_batch() = default;
+
+        // [private] Primitive batches are created with renderer::make_primitive_batch().
+        primitive_batch(view<renderer> rnd, pass_key<view<renderer>>);
+
+        // Queue a single point (pixel).
+        void point(coord::point pt, color c);
+
+        // Queue a line.
+        void line(coord::point from, coord::point to, color c);
+
+        // Queue a rectangle outline.
+        void outline(const coord::rect& area, color c);
+
+        // Queue a filled rectangle.
+        void fill(const coord::rect& area, color c);
+
+        // Preallocate space for a number of quads. Rectangle outlines take four.
+        void reserve(std::size_t quads);
+
+        // Submit all queued shapes in one call and empty the batch.
+        void flush();
+
+        // Discard all queued shapes.
+        void clear();
+
+        // The amount of queued quads.
+        std::size_t size() const;
+
+    private:
+        // Queue a quad from its corners, clockwise from the top left.
+        void quad(coord::point a, coord::point b, coord::point c, coord::point d, color clr);
+
+        view<renderer> m_rnd;
+
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int>        m_indices;
+    };
+}
\ No newline at end of file
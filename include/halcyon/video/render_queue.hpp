@@ -0,0 +1,148 @@
+#pragma once
+
+#include <bitset>
+#include <unordered_map>
+#include <vector>
+
+#include <halcyon/video/renderer.hpp>
+
+// video/render_queue.hpp:
+// Deferred sprite drawing, sorted to minimize state changes.
+
+namespace hal
+{
+    class render_queue;
+
+    // A builder for a single queued sprite. Works like a copyer,
+    // except that finishing the operation only queues the sprite.
+    class queued_sprite : public detail::drawer<const texture, coord_t, renderer, queued_sprite>
+    {
+    public:
+        // [private] Sprites are queued with render_queue::draw().
+        queued_sprite(render_queue& queue, view<renderer> rnd, view<const texture> tex, pass_key<render_queue>);
+
+        // Set the sprite's layer. Lower layers are drawn first.
+        [[nodiscard]] queued_sprite& layer(u8 l);
+
+        // Set the sprite's depth. Within a layer, blend mode and texture,
+        // lower depths are drawn first. Ignored in ordered layers.
+        [[nodiscard]] queued_sprite& depth(u16 d);
+
+        // Set the sprite's rotation (clockwise, in degrees).
+        [[nodiscard]] queued_sprite& rotate(f64 angle);
+
+        // Set the sprite's flip.
+        [[nodiscard]] queued_sprite& flip(enum flip f);
+
+        // Set the sprite's color and alpha modifier.
+        [[nodiscard]] queued_sprite& tint(color c);
+
+        // Queue the sprite.
+        void operator()();
+
+    private:
+        render_queue& m_queue;
+
+        f64 m_angle { 0.0 };
+
+        enum flip m_flip
+        {
+            flip::none
+        };
+
+        color m_tint { palette::white };
+
+        u16 m_depth { 0 };
+        u8  m_layer { 0 };
+    };
+
+    // Collects sprites from any number of textures and draws them at once. Sprites are sorted
+    // by a 64-bit key (layer, blend mode, texture, depth) with a radix sort, and consecutive
+    // sprites sharing a texture are merged into a single SDL_RenderGeometry call.
+    // Within a layer, sprites are only drawn in submission order if the layer is ordered;
+    // use that for layers where overlapping sprites from different textures must stack correctly.
+    // Queued sprites are drawn when the renderer presents, or earlier with flush().
+    // The renderer keeps track of its queues, so they can't be copied or moved.
+    class render_queue
+    {
+    public:
+        // [private] Render queues are created with renderer::make_render_queue().
+        render_queue(view<renderer> rnd, pass_key<view<renderer>>);
+
+        render_queue(const render_queue&) = delete;
+        render_queue(render_queue&&)      = delete;
+
+        ~render_queue();
+
+        // Start building a sprite.
+        [[nodiscard]] queued_sprite draw(view<const texture> tex);
+
+        // Queue a sprite directly.
+        // An unset source (x == max) means the entire texture, an unset destination means the entire target.
+        void push(view<const texture> tex, const pixel::rect& src, const coord::rect& dst, u8 layer = 0, u16 depth = 0, f64 angle = 0.0, enum flip f = flip::none, color tint = palette::white);
+
+        // Set whether a layer keeps its sprites in submission order.
+        void ordered(u8 layer, bool keep_order);
+
+        // Check whether a layer keeps its sprites in submission order.
+        bool ordered(u8 layer) const;
+
+        // Sort and draw all queued sprites, then empty the queue.
+        // Called by renderer::present(); call it yourself to draw the sprites
+        // earlier, e.g. before drawing something that must go on top of them.
+        void flush();
+
+        // Discard all queued sprites.
+        void clear();
+
+        // The amount of queued sprites.
+        std::size_t size() const;
+
+        // The amount of SDL draw calls made by the last flush.
+        std::size_t draw_calls() const;
+
+    private:
+        struct sprite
+        {
+            pixel::rect src;
+            coord::rect dst;
+            f64         angle;
+            u32         tex;
+            color       tint;
+            flip        f;
+        };
+
+        // A texture used by queued sprites.
+        struct texture_info
+        {
+            view<const hal::texture> tex;
+            coord::point             size;
+            u8                       blend;
+        };
+
+        // Get a small, per-flush ID for a texture.
+        u32 texture_id(view<const hal::texture> tex);
+
+        // Sort sprite indices by their keys.
+        void sort();
+
+        view<renderer> m_rnd;
+
+        std::vector<sprite> m_sprites;
+        std::vector<u64>    m_keys;
+
+        // Radix sort scratch space.
+        std::vector<u64> m_sortKeys, m_tmpKeys;
+        std::vector<u32> m_order, m_tmpOrder;
+
+        std::vector<texture_info>                   m_textures;
+        std::unordered_map<const SDL_Texture*, u32> m_textureIds;
+
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int>        m_indices;
+
+        std::bitset<256> m_ordered;
+
+        std::size_t m_drawCalls { 0 };
+    };
+}
\ No newline at end of file
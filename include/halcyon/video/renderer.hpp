@@ -25,6 +25,16 @@ namespace hal
 
     class static_texture;
     class target_texture;
+    class mip_texture;
+    class streaming_texture;
+    class buffered_texture;
+
+    class sprite_batch;
+    class render_queue;
+    class primitive_batch;
+    class mesh;
+
+    HAL_TAG(no_clear);
 
     enum class flip : u8
     {
@@ -39,6 +49,17 @@ namespace hal
         class renderer;
     }
 
+    // Counts of state-setting calls that were skipped because they wouldn't have changed anything.
+    struct elided_calls
+    {
+        u32 color { 0 }, blend { 0 }, target { 0 }, texture_mods { 0 };
+
+        constexpr u32 total() const
+        {
+            return color + blend + target + texture_mods;
+        }
+    };
+
     template <>
     class view<const renderer> : public detail::view_base<SDL_Renderer>
     {
@@ -56,6 +77,10 @@ namespace hal
         info::sdl::renderer info() const;
 
         view<const window> window() const;
+
+        // Get the amount of redundant calls skipped during the last presented frame.
+        // Texture modifier calls are counted on the renderer that created the texture.
+        hal::elided_calls elided_calls() const;
     };
 
     template <>
@@ -70,8 +95,17 @@ namespace hal
         void clear();
 
         // Present the back-buffer and clear it.
+        // Sprites queued in this renderer's render queues are drawn first.
         void present();
 
+        // Present the back-buffer, leaving it as-is. Skips a wasted clear
+        // when the next frame is going to overdraw the whole target anyway.
+        void present(HAL_TAG_NAME(no_clear));
+
+        // [private] Render queues register themselves to be flushed by present().
+        void attach(render_queue& q, pass_key<render_queue>);
+        void detach(render_queue& q, pass_key<render_queue>);
+
         // Draw a single point (pixel) with the current color.
         void draw(coord::point pt);
 
@@ -81,12 +115,28 @@ namespace hal
         // Outline a rectangle with the current color.
         void draw(coord::rect area);
 
+        // Draw many points with the current color, in a single call.
+        void draw_points(std::span<const coord::point> pts);
+
+        // Draw connected lines through a series of points with the current color, in a single call.
+        void draw_lines(std::span<const coord::point> pts);
+
+        // Outline many rectangles with the current color, in a single call.
+        void draw_rects(std::span<const coord::rect> areas);
+
+        // Draw a mesh in a single call, optionally textured.
+        // An empty texture view draws with vertex colors only.
+        void draw(const mesh& m, view<const texture> tex = {});
+
         void fill(coord::rect area);
         void fill(std::span<const coord::rect> areas);
         void fill();
 
         // Get/set the rendering target.
+        // An empty view means the window is being rendered to.
+        view<texture> target();
         void target(target_texture& tx);
+        void target(view<texture> tx);
         void reset_target();
 
         using super::color;
@@ -104,11 +154,30 @@ namespace hal
 
         // Texture creation functions.
         [[nodiscard]] static_texture make_texture(view<const surface> surf) &;
+        [[nodiscard]] mip_texture    make_texture(view<const surface> surf, HAL_TAG_NAME(mipmapped), enum filter f = filter::box) &;
         [[nodiscard]] target_texture make_target_texture(pixel::point size) &;
 
+        // Create textures meant to be rewritten often, i.e. every frame.
+        [[nodiscard]] streaming_texture make_streaming_texture(pixel::point size, pixel::format fmt = pixel::format::rgba32) &;
+        [[nodiscard]] buffered_texture  make_buffered_texture(pixel::point size, pixel::format fmt = pixel::format::rgba32) &;
+
+        // Create a sprite batch for a texture. Use it when drawing
+        // lots of sprites from a single texture, such as an atlas.
+        [[nodiscard]] sprite_batch make_sprite_batch(view<const texture> tex) &;
+
+        // Create a render queue, which sorts sprites from many textures into few draw calls.
+        [[nodiscard]] render_queue make_render_queue() &;
+
+        // Create a primitive batch, which draws many colored shapes in a single call.
+        [[nodiscard]] primitive_batch make_primitive_batch() &;
+
         // Render a texture via a builder.
         [[nodiscard]] copyer render(view<const texture> tex);
 
+        // Render a mipmapped texture via a builder.
+        // The texture must outlive the builder.
+        [[nodiscard]] copyer render(const mip_texture& tex);
+
     private:
         // Helper for setting the render target.
         void internal_target(SDL_Texture* target);
@@ -118,6 +187,8 @@ namespace hal
     // is attached to a window. Multiple renderers can exist for a single window, i.e. a hardware-
     // accelerated one, plus a software fallback in case the former isn't available.
     // By default, renderers use hardware acceleration. You can override this via renderer flags.
+    // The draw color and blend mode are cached, so that setting them to their current values is
+    // skipped. Changing them by calling SDL directly through get() makes the cache out of date.
     class renderer : public detail::raii_object<renderer, &::SDL_DestroyRenderer>
     {
     public:
@@ -185,6 +256,9 @@ namespace hal
     public:
         using drawer::drawer;
 
+        // [private] Mipmapped textures are rendered with renderer::render().
+        copyer(view<renderer> rnd, const mip_texture& tex, pass_key<view<renderer>>);
+
         // Set the texture's rotation.
         // Can be called at any time.
         [[nodiscard]] copyer& rotate(f64 angle);
@@ -213,5 +287,7 @@ namespace hal
         {
             flip::none
         };
+
+        const mip_texture* m_mips { nullptr };
     };
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <halcyon/video/renderer.hpp>
+
+// video/sprite_batch.hpp:
+// Many copies of a single texture, submitted in one go.
+
+namespace hal
+{
+    class sprite_batch;
+
+    namespace detail
+    {
+        // Append a sprite's four vertices, clockwise from the top left. The destination must be set;
+        // an unset source (x == max) means the entire texture. Rotation pivots around the center.
+        void append_quad(std::vector<SDL_Vertex>& vertices, const pixel::rect& src, const coord::rect& dst, coord::point tex_size, f64 angle, enum flip f, color tint);
+
+        // Make sure an index buffer covers a number of quads. Indices are relative to the first
+        // vertex passed to SDL_RenderGeometry, so one buffer serves any range of quads.
+        void grow_quad_indices(std::vector<int>& indices, std::size_t quads);
+    }
+
+    // A builder for a single sprite in a batch. Works like a copyer,
+    // except that finishing the operation only queues the sprite.
+    class batch_sprite : public detail::drawer<const texture, coord_t, renderer, batch_sprite>
+    {
+    public:
+        // [private] Sprites are added with sprite_batch::draw().
+        batch_sprite(sprite_batch& batch, view<renderer> rnd, view<const texture> tex, coord::point tex_size, pass_key<sprite_batch>);
+
+        // Set the sprite's rotation (clockwise, in degrees).
+        [[nodiscard]] batch_sprite& rotate(f64 angle);
+
+        // Set the sprite's flip.
+        [[nodiscard]] batch_sprite& flip(enum flip f);
+
+        // Set the sprite's color and alpha modifier.
+        [[nodiscard]] batch_sprite& tint(color c);
+
+        // Queue the sprite.
+        void operator()();
+
+    private:
+        sprite_batch& m_batch;
+
+        f64 m_angle { 0.0 };
+
+        enum flip m_flip
+        {
+            flip::none
+        };
+
+        color m_tint { palette::white };
+    };
+
+    // Collects sprites from one texture (typically an atlas) and draws them with a single
+    // SDL_RenderGeometry call. Index data never changes between flushes, so it's built once
+    // and only grows; vertex data is rebuilt on every push.
+    class sprite_batch
+    {
+    public:
+        sprite_batch() = default;
+
+        // [private] Sprite batches are created with renderer::make_sprite_batch().
+        sprite_batch(view<renderer> rnd, view<const texture> tex, pass_key<view<renderer>>);
+
+        // Start building a sprite.
+        [[nodiscard]] batch_sprite draw();
+
+        // Queue a sprite directly.
+        // An unset source (x == max) means the entire texture, an unset destination means the entire target.
+        void push(const pixel::rect& src, const coord::rect& dst, f64 angle = 0.0, enum flip f = flip::none, color tint = palette::white);
+
+        // Preallocate space for a number of sprites.
+        void reserve(std::size_t sprites);
+
+        // Submit all queued sprites in one call and empty the batch.
+        void flush();
+
+        // Discard all queued sprites.
+        void clear();
+
+        // The amount of queued sprites.
+        std::size_t size() const;
+
+        view<const hal::texture> texture() const;
+
+    private:
+        view<hal::renderer>      m_rnd;
+        view<const hal::texture> m_tex;
+
+        coord::point m_texSize;
+
+        std::vector<SDL_Vertex> m_vertices;
+        std::vector<int>        m_indices;
+    };
+}
\ No newline at end of file
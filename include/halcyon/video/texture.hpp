@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <span>
+#include <vector>
+
 #include <SDL_render.h>
 
 #include <halcyon/utility/pass_key.hpp>
 
 #include <halcyon/internal/raii_object.hpp>
+#include <halcyon/internal/scaler.hpp>
 #include <halcyon/types/color.hpp>
 #include <halcyon/video/types.hpp>
 
@@ -15,6 +20,19 @@ namespace hal
 {
     class surface;
     class texture;
+    class renderer;
+    class command_buffer;
+
+    HAL_TAG(mipmapped);
+
+    namespace detail
+    {
+        // Get and reset the amount of modifier calls skipped on a renderer's textures.
+        u32 take_elided_texture_mods(const SDL_Renderer* rnd);
+
+        // Destroy a texture, forgetting its cached modifiers.
+        void destroy_texture(SDL_Texture* tex);
+    }
 
     template <>
     class view<const texture> : public detail::view_base<SDL_Texture>
@@ -46,6 +64,12 @@ namespace hal
     public:
         using super::super;
 
+        // [private] Render target views are obtained with renderer::target().
+        view(SDL_Texture* ptr, pass_key<view<renderer>>);
+
+        // [private] Recorded render targets are replayed with command_buffer::replay().
+        view(SDL_Texture* ptr, pass_key<command_buffer>);
+
         using super::opacity;
         void opacity(color::value_t value);
 
@@ -60,17 +84,16 @@ namespace hal
     };
 
     // Common texture functionality.
-    class texture : public detail::raii_object<texture,&::SDL_DestroyTexture>
+    // Modifiers (alpha, color and blend mode) are cached, so that setting them to their current
+    // values is skipped. Changing them by calling SDL directly through get() makes the cache out of date.
+    class texture : public detail::raii_object<texture, &detail::destroy_texture>
     {
     protected:
         texture() = default;
 
-        texture(SDL_Texture* ptr);
+        texture(SDL_Texture* ptr, view<const renderer> rnd);
     };
 
-    // Forward declarations for parameters and return types.
-    class renderer;
-
     // A texture that cannot be drawn onto, only reassigned.
     class static_texture : public texture
     {
@@ -90,4 +113,145 @@ namespace hal
         // [private] Target textures are created with renderer::load().
         target_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size);
     };
+
+    // A texture whose pixels are meant to be rewritten often, e.g. every frame.
+    // Video frames, procedural content and such should use this instead of
+    // recreating a static texture.
+    class streaming_texture : public texture
+    {
+    public:
+        // Direct write access to (part of) a streaming texture's pixels.
+        // The pixels' previous contents are undefined, so write every one of them.
+        // Changes are uploaded when the lock is destroyed.
+        class lock_guard
+        {
+        public:
+            // [private] Locks are obtained with streaming_texture::lock().
+            lock_guard(streaming_texture& tex, const pixel::rect* area, pass_key<streaming_texture>);
+
+            lock_guard(const lock_guard&) = delete;
+            lock_guard(lock_guard&&)      = delete;
+
+            ~lock_guard();
+
+            // Get a row of the locked area.
+            std::span<std::byte> row(pixel_t y) const;
+
+            // Get all locked bytes, including any padding at the end of rows.
+            std::span<std::byte> bytes() const;
+
+            // The distance between rows, in bytes.
+            int pitch() const;
+
+            pixel::point size() const;
+
+        private:
+            SDL_Texture* m_tex;
+            std::byte*   m_pixels;
+            int          m_pitch;
+            pixel::point m_size;
+            int          m_rowBytes;
+        };
+
+        streaming_texture() = default;
+
+        // [private] Streaming textures are created with renderer::make_streaming_texture().
+        streaming_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size);
+
+        // Lock the entire texture for writing.
+        [[nodiscard]] lock_guard lock();
+
+        // Lock an area of the texture for writing.
+        [[nodiscard]] lock_guard lock(const pixel::rect& area);
+
+        // Copy pixels into an area. Rows in the source are [pitch] bytes apart.
+        void update(const pixel::rect& area, std::span<const std::byte> pixels, int pitch);
+
+        // Copy tightly packed pixels into an area.
+        void update(const pixel::rect& area, std::span<const std::byte> pixels);
+    };
+
+    // A pair of streaming textures that take turns being drawn, fed from a CPU-side copy of the pixels.
+    // Updates are only uploaded on swap(), and only where something changed since that texture was
+    // last written. The texture that's currently drawn is never touched, so the renderer doesn't
+    // have to wait for the GPU to finish with it.
+    class buffered_texture
+    {
+    public:
+        buffered_texture() = default;
+
+        // [private] Buffered textures are created with renderer::make_buffered_texture().
+        buffered_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size);
+
+        // Copy pixels into an area. Rows in the source are [pitch] bytes apart.
+        void update(const pixel::rect& area, std::span<const std::byte> pixels, int pitch);
+
+        // Copy tightly packed pixels into an area.
+        void update(const pixel::rect& area, std::span<const std::byte> pixels);
+
+        // Upload changed areas to the back texture and bring it to the front.
+        void swap();
+
+        // Get the texture to draw.
+        view<const texture> front() const;
+
+        pixel::point size() const;
+
+        pixel::format pixel_format() const;
+
+    private:
+        std::array<streaming_texture, 2>        m_textures;
+        std::array<std::vector<pixel::rect>, 2> m_dirty;
+
+        std::vector<std::byte> m_pixels;
+        int                    m_pitch { 0 };
+
+        pixel::point  m_size { 0, 0 };
+        pixel::format m_format { pixel::format::unknown };
+
+        u8 m_front { 0 };
+    };
+
+    // A texture with a chain of pre-downscaled copies (levels), each half the size of the previous one.
+    // When rendered, the level closest to (but not smaller than) the destination is drawn, which
+    // reduces shimmering in heavily downscaled sprites and saves on sampling bandwidth.
+    class mip_texture
+    {
+    public:
+        mip_texture() = default;
+
+        // [private] Mipmapped textures are created with renderer::make_texture().
+        mip_texture(view<const renderer> rnd, view<const surface> surf, enum filter f);
+
+        // Get a level. Level 0 is the full-size texture.
+        view<const texture> level(std::size_t idx) const;
+
+        // Get the size of a level.
+        pixel::point level_size(std::size_t idx) const;
+
+        // Get the most fitting level for drawing part of the full-size texture into a destination.
+        std::size_t level_for(pixel::point src, coord::point dst) const;
+
+        // The amount of levels.
+        std::size_t levels() const;
+
+        // Get the full-size texture's size.
+        pixel::point size() const;
+
+        // Set the opacity of all levels.
+        void opacity(color::value_t value);
+
+        // Set the color modifier of all levels.
+        void color_mod(color mod);
+
+        // Set the blend mode of all levels.
+        void blend(blend_mode bm);
+
+        bool valid() const;
+
+    private:
+        std::vector<static_texture> m_levels;
+
+        pixel::point m_size { 0, 0 };
+    };
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include <halcyon/video/renderer.hpp>
+#include <halcyon/video/texture.hpp>
+
+#include <halcyon/surface.hpp>
+
+// video/upload_queue.hpp:
+// Spreading texture uploads over multiple frames.
+
+namespace hal
+{
+    // Turns surfaces decoded in the background into textures on the render thread,
+    // without uploading more per frame than a time budget allows:
+    //
+    // queue.push(ictx.load("tiles.png", pool), [&](static_texture tex) { tiles = std::move(tex); });
+    // ...and once per frame:
+    // queue.process(std::chrono::milliseconds { 2 });
+    class upload_queue
+    {
+    public:
+        using callback = std::move_only_function<void(static_texture)>;
+
+        upload_queue(view<renderer> rnd);
+
+        // Queue a surface that's being decoded. The function receives the finished texture.
+        void push(std::future<surface> surf, callback done);
+
+        // Upload surfaces that have finished decoding until the budget runs out.
+        // At least one surface is uploaded (if any is ready), so the queue always makes progress.
+        // Returns the amount of uploaded surfaces.
+        std::size_t process(std::chrono::nanoseconds budget);
+
+        // Block until everything is decoded and uploaded.
+        void finish();
+
+        // The amount of surfaces yet to be uploaded.
+        std::size_t size() const;
+
+        bool empty() const;
+
+    private:
+        struct pending
+        {
+            std::future<surface> surf;
+            callback             done;
+        };
+
+        // Upload a single surface and notify its owner.
+        void upload(pending& p);
+
+        view<renderer> m_rnd;
+
+        std::vector<pending> m_pending;
+    };
+}
\ No newline at end of file
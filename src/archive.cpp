@@ -0,0 +1,377 @@
+#include <halcyon/archive.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <halcyon/debug.hpp>
+#include <halcyon/profiler.hpp>
+
+#ifdef HAL_ARCHIVE_LZ4
+    #include <lz4.h>
+    #include <lz4hc.h>
+#endif
+
+#ifdef HAL_ARCHIVE_ZSTD
+    #include <zstd.h>
+#endif
+
+using namespace hal;
+
+namespace
+{
+    constexpr char magic[4] { 'H', 'L', 'A', 'R' };
+    constexpr u32  version { 1 };
+
+    struct header
+    {
+        char magic[4];
+        u32  version;
+        u32  count;
+        u32  names_size;
+    };
+
+    static_assert(sizeof(header) == 16);
+
+    // Archives are little-endian. Converting twice gives back the original.
+    template <std::integral T>
+    constexpr T little_endian(T val)
+    {
+        if constexpr (compile_settings::byte_order == byte_order::big_endian)
+            return std::byteswap(val);
+        else
+            return val;
+    }
+
+    header little_endian(header hdr)
+    {
+        hdr.version    = little_endian(hdr.version);
+        hdr.count      = little_endian(hdr.count);
+        hdr.names_size = little_endian(hdr.names_size);
+
+        return hdr;
+    }
+
+    // FNV-1a.
+    constexpr u64 hash(std::string_view str)
+    {
+        u64 ret { 0xCBF29CE484222325 };
+
+        for (const char c : str)
+        {
+            ret ^= static_cast<u8>(c);
+            ret *= 0x100000001B3;
+        }
+
+        return ret;
+    }
+
+    std::vector<std::byte> compress([[maybe_unused]] std::span<const std::byte> src, archive::compression method)
+    {
+        std::vector<std::byte> ret;
+
+        switch (method)
+        {
+        case archive::compression::none:
+            break;
+
+        case archive::compression::lz4:
+#ifdef HAL_ARCHIVE_LZ4
+            ret.resize(static_cast<std::size_t>(::LZ4_compressBound(static_cast<int>(src.size()))));
+            ret.resize(static_cast<std::size_t>(::LZ4_compress_HC(reinterpret_cast<const char*>(src.data()), reinterpret_cast<char*>(ret.data()),
+                static_cast<int>(src.size()), static_cast<int>(ret.size()), LZ4HC_CLEVEL_DEFAULT)));
+#endif
+            break;
+
+        case archive::compression::zstd:
+#ifdef HAL_ARCHIVE_ZSTD
+        {
+            ret.resize(::ZSTD_compressBound(src.size()));
+
+            // Packing is done offline, so spend the time.
+            const std::size_t size { ::ZSTD_compress(ret.data(), ret.size(), src.data(), src.size(), 19) };
+            ret.resize(::ZSTD_isError(size) ? 0 : size);
+        }
+#endif
+        break;
+        }
+
+        return ret;
+    }
+
+    bool decompress([[maybe_unused]] std::span<const std::byte> src, [[maybe_unused]] std::span<std::byte> dst, archive::compression method)
+    {
+        switch (method)
+        {
+        case archive::compression::none:
+            return false;
+
+        case archive::compression::lz4:
+#ifdef HAL_ARCHIVE_LZ4
+            return ::LZ4_decompress_safe(reinterpret_cast<const char*>(src.data()), reinterpret_cast<char*>(dst.data()),
+                       static_cast<int>(src.size()), static_cast<int>(dst.size()))
+                == static_cast<int>(dst.size());
+#else
+            return false;
+#endif
+
+        case archive::compression::zstd:
+#ifdef HAL_ARCHIVE_ZSTD
+            return ::ZSTD_decompress(dst.data(), dst.size(), src.data(), src.size()) == dst.size();
+#else
+            return false;
+#endif
+        }
+
+        return false;
+    }
+
+    // SDL's memory RWops can't be empty.
+    struct empty_source
+    {
+        std::size_t read(std::span<std::byte>)
+        {
+            return 0;
+        }
+
+        i64 seek(i64 offset, seek_origin)
+        {
+            return offset == 0 ? 0 : -1;
+        }
+
+        i64 size()
+        {
+            return 0;
+        }
+    };
+
+    constexpr std::size_t aligned(std::size_t pos)
+    {
+        return (pos + archive::alignment - 1) / archive::alignment * archive::alignment;
+    }
+}
+
+archive::archive(const char* path)
+    : m_map { path, detail::file_map::access::random }
+{
+    HAL_ASSERT_VITAL(m_map.valid(), "Could not map archive ", path);
+
+    const std::span<const std::byte> data { m_map.data() };
+
+    header hdr;
+
+    HAL_ASSERT_VITAL(data.size() >= sizeof(hdr), "Archive too small: ", path);
+
+    std::memcpy(&hdr, data.data(), sizeof(hdr));
+    hdr = little_endian(hdr);
+
+    HAL_ASSERT_VITAL(std::ranges::equal(hdr.magic, magic) && hdr.version == version, "Not a Halcyon archive: ", path);
+    HAL_ASSERT_VITAL(sizeof(hdr) + hdr.count * sizeof(record) + hdr.names_size <= data.size(), "Archive truncated: ", path);
+
+    m_records.resize(hdr.count);
+    std::memcpy(m_records.data(), data.data() + sizeof(hdr), hdr.count * sizeof(record));
+
+    if constexpr (compile_settings::byte_order == byte_order::big_endian)
+        std::ranges::transform(m_records, m_records.begin(), &record::little_endian);
+
+    m_names = reinterpret_cast<const char*>(data.data() + sizeof(hdr) + hdr.count * sizeof(record));
+
+    // Lookups and opening trust the index from here on.
+    for (const record& rec : m_records)
+    {
+        HAL_ASSERT_VITAL(rec.offset <= data.size() && rec.stored_size <= data.size() - rec.offset, "Archive entry out of bounds: ", path);
+        HAL_ASSERT_VITAL(static_cast<u64>(rec.name_offset) + rec.name_size <= hdr.names_size, "Archive entry name out of bounds: ", path);
+    }
+
+    HAL_PRINT("Mapped archive ", path, " [entries: ", hdr.count, ", size: ", data.size(), ']');
+}
+
+archive::archive(std::string_view path)
+    : archive { path.data() }
+{
+}
+
+accessor archive::open(std::string_view name) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    const record* const rec { find(name) };
+
+    HAL_ASSERT_VITAL(rec != nullptr, "Entry not found in archive: ", name);
+
+    const std::span<const std::byte> stored { m_map.data().subspan(rec->offset, rec->stored_size) };
+
+    if (stored.empty())
+        return { empty_source {}, 0 };
+
+    if (rec->method == compression::none)
+        return stored;
+
+    HAL_ASSERT_VITAL(supports(rec->method), "Compression method of ", name, " not supported by this build");
+
+    std::unique_ptr<std::byte[]> buf { new std::byte[rec->size] };
+
+    HAL_ASSERT_VITAL(decompress(stored, { buf.get(), rec->size }, rec->method), "Could not decompress ", name);
+
+    return { std::move(buf), rec->size, pass_key<archive> {} };
+}
+
+bool archive::contains(std::string_view name) const
+{
+    return find(name) != nullptr;
+}
+
+std::size_t archive::size() const
+{
+    return m_records.size();
+}
+
+std::string_view archive::name(std::size_t index) const
+{
+    return { m_names + m_records[index].name_offset, m_records[index].name_size };
+}
+
+bool archive::valid() const
+{
+    return m_map.valid();
+}
+
+archive::record archive::record::little_endian() const
+{
+    record ret { *this };
+
+    ret.hash        = ::little_endian(hash);
+    ret.offset      = ::little_endian(offset);
+    ret.size        = ::little_endian(size);
+    ret.stored_size = ::little_endian(stored_size);
+    ret.name_offset = ::little_endian(name_offset);
+    ret.name_size   = ::little_endian(name_size);
+
+    return ret;
+}
+
+const archive::record* archive::find(std::string_view name) const
+{
+    const u64 h { hash(name) };
+
+    // Equal hashes are next to each other; names tell them apart.
+    for (auto it = std::ranges::lower_bound(m_records, h, {}, &record::hash); it != m_records.end() && it->hash == h; ++it)
+    {
+        if (std::string_view { m_names + it->name_offset, it->name_size } == name)
+            return &*it;
+    }
+
+    return nullptr;
+}
+
+void archive::writer::add(std::string_view name, std::span<const std::byte> data, compression method)
+{
+    HAL_ASSERT(supports(method), "Compression method not supported by this build");
+    HAL_ASSERT(name.size() <= UINT16_MAX && data.size() <= INT32_MAX, "Archive entry too large");
+
+    std::vector<std::byte> packed { compress(data, method) };
+
+    // Not worth it; store as-is.
+    if (packed.empty() || packed.size() >= data.size())
+    {
+        packed.assign(data.begin(), data.end());
+        method = compression::none;
+    }
+
+    m_entries.push_back({ std::string { name }, std::move(packed), static_cast<u32>(data.size()), method });
+}
+
+void archive::writer::add(std::string_view name, const char* path, compression method)
+{
+    const detail::file_map map { path, detail::file_map::access::sequential };
+
+    // Empty files can't be mapped, but make for perfectly fine entries.
+    if (!map.valid())
+    {
+        std::error_code ec;
+
+        HAL_ASSERT_VITAL(std::ifstream { path }.is_open() && std::filesystem::file_size(path, ec) == 0 && !ec, "Could not read ", path);
+    }
+
+    add(name, map.data(), method);
+}
+
+std::size_t archive::writer::size() const
+{
+    return m_entries.size();
+}
+
+void archive::writer::save(outputter dst) const
+{
+    std::vector<const pending*> sorted(m_entries.size());
+    std::ranges::transform(m_entries, sorted.begin(), [](const pending& p)
+        { return &p; });
+
+    std::ranges::sort(sorted, [](const pending* lhs, const pending* rhs)
+        { return std::pair { hash(lhs->name), std::string_view { lhs->name } } < std::pair { hash(rhs->name), std::string_view { rhs->name } }; });
+
+    HAL_ASSERT(std::ranges::adjacent_find(sorted, [](const pending* lhs, const pending* rhs)
+                   { return lhs->name == rhs->name; })
+            == sorted.end(),
+        "Duplicate archive entries");
+
+    std::vector<record> records(sorted.size());
+    std::string         names;
+
+    std::size_t pos { sizeof(header) + sorted.size() * sizeof(record) };
+
+    for (const pending* p : sorted)
+        pos += p->name.size();
+
+    for (std::size_t i { 0 }; i < sorted.size(); ++i)
+    {
+        const pending& p { *sorted[i] };
+
+        pos = aligned(pos);
+
+        records[i] = { hash(p.name), pos, p.size, static_cast<u32>(p.data.size()), static_cast<u32>(names.size()), static_cast<u16>(p.name.size()), p.method, 0 };
+
+        names += p.name;
+        pos += p.data.size();
+    }
+
+    header hdr { {}, version, static_cast<u32>(records.size()), static_cast<u32>(names.size()) };
+    std::ranges::copy(magic, hdr.magic);
+
+    hdr = little_endian(hdr);
+
+    SDL_RWops* const ops { dst.use(pass_key<archive> {}) };
+
+    const auto write = [ops](const void* data, std::size_t size)
+    {
+        // Empty entries have no data to point to.
+        if (size == 0)
+            return;
+
+        HAL_ASSERT_VITAL(::SDL_RWwrite(ops, data, 1, size) == size, debug::last_error());
+    };
+
+    constexpr std::byte padding[alignment] {};
+
+    // The offsets are still needed below, in native order.
+    std::vector<record> index(records.size());
+    std::ranges::transform(records, index.begin(), &record::little_endian);
+
+    write(&hdr, sizeof(hdr));
+    write(index.data(), index.size() * sizeof(record));
+    write(names.data(), names.size());
+
+    pos = sizeof(header) + records.size() * sizeof(record) + names.size();
+
+    for (std::size_t i { 0 }; i < sorted.size(); ++i)
+    {
+        write(padding, records[i].offset - pos);
+        write(sorted[i]->data.data(), sorted[i]->data.size());
+
+        pos = records[i].offset + sorted[i]->data.size();
+    }
+
+    ::SDL_RWclose(ops);
+}
\ No newline at end of file
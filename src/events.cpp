@@ -107,6 +107,30 @@ bool proxy::events::poll(event::holder& eh)
     return static_cast<bool>(::SDL_PollEvent(eh.get(pass_key<subsystem> {})));
 }
 
+std::size_t proxy::events::poll(event::batch& b)
+{
+    constexpr pass_key<subsystem> pk {};
+
+    ::SDL_PumpEvents();
+
+    b.clear(pk);
+
+    while (true)
+    {
+        const std::span<event::holder> space { b.space(pk) };
+
+        const int count { ::SDL_PeepEvents(space.front().get(pk), static_cast<int>(space.size()), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) };
+
+        HAL_ASSERT_VITAL(count >= 0, debug::last_error());
+
+        b.commit(static_cast<std::size_t>(count), pk);
+
+        // Only a full buffer means there might be more.
+        if (static_cast<std::size_t>(count) < space.size())
+            return b.size();
+    }
+}
+
 void proxy::events::push(const event::holder& eh)
 {
 #ifdef HAL_DEBUG_ENABLED
@@ -1,6 +1,7 @@
 // Due to strcpy. Don't worry, it's used "safely" here.
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <algorithm>
 #include <cstring>
 
 #include <halcyon/debug.hpp>
@@ -467,4 +468,54 @@ bool event::holder::pending() const
 SDL_Event* event::holder::get(pass_key<proxy::events>) const
 {
     return reinterpret_cast<SDL_Event*>(const_cast<dummy_event*>(&m_event));
+}
+
+event::batch::batch(std::size_t capacity)
+    : m_events(std::max<std::size_t>(capacity, 1))
+{
+}
+
+std::span<const event::holder> event::batch::events() const
+{
+    return { m_events.data(), m_size };
+}
+
+const event::holder* event::batch::begin() const
+{
+    return m_events.data();
+}
+
+const event::holder* event::batch::end() const
+{
+    return m_events.data() + m_size;
+}
+
+std::size_t event::batch::size() const
+{
+    return m_size;
+}
+
+bool event::batch::empty() const
+{
+    return m_size == 0;
+}
+
+void event::batch::clear(pass_key<proxy::events>)
+{
+    m_size = 0;
+}
+
+std::span<event::holder> event::batch::space(pass_key<proxy::events>)
+{
+    if (m_size == m_events.size())
+        m_events.resize(m_events.size() * 2);
+
+    return std::span { m_events }.subspan(m_size);
+}
+
+void event::batch::commit(std::size_t count, pass_key<proxy::events>)
+{
+    HAL_ASSERT(m_size + count <= m_events.size(), "Committing more events than there is space for");
+
+    m_size += count;
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <halcyon/events/input.hpp>
+
+#include <utility>
+
+using namespace hal;
+
+bool input::snapshot::operator[](keyboard::button btn) const
+{
+    return keys[static_cast<std::size_t>(std::to_underlying(btn))];
+}
+
+bool input::snapshot::operator[](mouse::button btn) const
+{
+    return static_cast<bool>(buttons & SDL_BUTTON(std::to_underlying(btn)));
+}
+
+void input::tracker::feed(const event::holder& eh)
+{
+    eh.visit(*this);
+}
+
+void input::tracker::operator()(event::on<event::type::key_pressed>, const event::keyboard& e)
+{
+    m_current.keys.set(static_cast<std::size_t>(std::to_underlying(e.button())));
+}
+
+void input::tracker::operator()(event::on<event::type::key_released>, const event::keyboard& e)
+{
+    m_current.keys.reset(static_cast<std::size_t>(std::to_underlying(e.button())));
+}
+
+void input::tracker::operator()(event::on<event::type::mouse_moved>, const event::mouse_motion& e)
+{
+    m_current.pos = e.pos();
+    m_current.delta += e.rel();
+}
+
+void input::tracker::operator()(event::on<event::type::mouse_pressed>, const event::mouse_button& e)
+{
+    m_current.pos = e.pos();
+    m_current.buttons |= static_cast<u8>(SDL_BUTTON(std::to_underlying(e.button())));
+}
+
+void input::tracker::operator()(event::on<event::type::mouse_released>, const event::mouse_button& e)
+{
+    m_current.pos = e.pos();
+    m_current.buttons &= static_cast<u8>(~SDL_BUTTON(std::to_underlying(e.button())));
+}
+
+void input::tracker::operator()(event::on<event::type::mouse_wheel_moved>, const event::mouse_wheel& e)
+{
+    const point<f32> scroll { e.scroll_precise() };
+
+    // Report natural scrolling the same as regular scrolling.
+    m_current.wheel += e.scroll_flipped() ? point<f32> { -scroll.x, -scroll.y } : scroll;
+}
+
+void input::tracker::publish()
+{
+    ++m_current.frame;
+
+    m_published.back() = m_current;
+    m_published.publish();
+
+    // Held state carries over; per-frame amounts don't.
+    m_current.delta = { 0, 0 };
+    m_current.wheel = { 0.0f, 0.0f };
+}
+
+const input::snapshot& input::tracker::current() const
+{
+    return m_current;
+}
+
+const input::snapshot& input::tracker::latest()
+{
+    return m_published.read();
+}
\ No newline at end of file
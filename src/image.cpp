@@ -1,5 +1,9 @@
 #include <halcyon/image.hpp>
 
+#include <halcyon/profiler.hpp>
+
+#include <halcyon/utility/thread_pool.hpp>
+
 using namespace hal::image;
 
 context::context(std::initializer_list<init_format> types)
@@ -22,11 +26,15 @@ context::~context()
 
 hal::surface context::load(accessor src) const
 {
+    HAL_PROFILE_FUNCTION();
+
     return { ::IMG_Load_RW(src.use(pass_key<context> {}), true), pass_key<context> {} };
 }
 
 hal::surface context::load(accessor src, load_format fmt) const
 {
+    HAL_PROFILE_FUNCTION();
+
     using enum load_format;
 
     constexpr std::pair<load_format, func_ptr<SDL_Surface*, SDL_RWops*>> dispatch[] {
@@ -57,8 +65,39 @@ hal::surface context::load(accessor src, load_format fmt) const
     HAL_PANIC("Trying to load image of unknown type");
 }
 
+std::future<hal::surface> context::load(accessor src, thread_pool& pool) const
+{
+    std::promise<surface> prom;
+
+    std::future<surface> ret { prom.get_future() };
+
+    pool.submit([this, src = std::move(src), prom = std::move(prom)]() mutable
+        { prom.set_value(load(std::move(src))); });
+
+    return ret;
+}
+
+std::vector<std::future<hal::surface>> context::load(std::vector<accessor> srcs, thread_pool& pool) const
+{
+    std::vector<std::future<surface>> ret;
+    ret.reserve(srcs.size());
+
+    for (accessor& src : srcs)
+        ret.push_back(load(std::move(src), pool));
+
+    return ret;
+}
+
+void context::load(accessor src, thread_pool& pool, std::move_only_function<void(surface)> done) const
+{
+    pool.submit([this, src = std::move(src), done = std::move(done)]() mutable
+        { done(load(std::move(src))); });
+}
+
 void context::save(view<const surface> surf, save_format fmt, outputter dst) const
 {
+    HAL_PROFILE_FUNCTION();
+
     constexpr u8 jpg_quality { 90 };
 
     switch (fmt)
@@ -76,6 +115,8 @@ void context::save(view<const surface> surf, save_format fmt, outputter dst) con
 
 load_format context::query(const accessor& src) const
 {
+    HAL_PROFILE_FUNCTION();
+
     using enum load_format;
 
     constexpr std::pair<func_ptr<int, SDL_RWops*>, load_format> dispatch[] {
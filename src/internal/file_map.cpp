@@ -0,0 +1,119 @@
+#include <halcyon/internal/file_map.hpp>
+
+#include <climits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+    #define HAL_FILE_MAP_MMAP
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+    #include <memory>
+#endif
+
+using namespace hal::detail;
+
+file_map::file_map(const char* path, access hint)
+{
+#ifdef HAL_FILE_MAP_MMAP
+    const int fd { ::open(path, O_RDONLY | O_CLOEXEC) };
+
+    if (fd == -1)
+        return;
+
+    struct stat st;
+
+    void* data { MAP_FAILED };
+
+    if (::fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size <= INT_MAX)
+        data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps the file alive on its own.
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+        return;
+
+    m_data = { static_cast<const std::byte*>(data), static_cast<std::size_t>(st.st_size) };
+
+    switch (hint)
+    {
+    case access::sequential:
+        // Start paging in right away.
+        ::madvise(data, m_data.size(), MADV_SEQUENTIAL);
+        ::madvise(data, m_data.size(), MADV_WILLNEED);
+        break;
+
+    case access::random:
+        ::madvise(data, m_data.size(), MADV_RANDOM);
+        break;
+    }
+#else
+    static_cast<void>(hint);
+
+    std::ifstream file { path, std::ios::binary | std::ios::ate };
+
+    if (!file)
+        return;
+
+    const std::streamoff size { file.tellg() };
+
+    if (size <= 0 || size > INT_MAX)
+        return;
+
+    std::unique_ptr<std::byte[]> buf { new std::byte[static_cast<std::size_t>(size)] };
+
+    if (!file.seekg(0).read(reinterpret_cast<char*>(buf.get()), size))
+        return;
+
+    m_data = { buf.release(), static_cast<std::size_t>(size) };
+#endif
+}
+
+file_map::file_map(file_map&& other) noexcept
+    : m_data { other.release() }
+{
+}
+
+file_map& file_map::operator=(file_map&& other) noexcept
+{
+    free(std::exchange(m_data, other.release()));
+
+    return *this;
+}
+
+file_map::~file_map()
+{
+    free(m_data);
+}
+
+std::span<const std::byte> file_map::data() const
+{
+    return m_data;
+}
+
+bool file_map::valid() const
+{
+    return !m_data.empty();
+}
+
+std::span<const std::byte> file_map::release()
+{
+    return std::exchange(m_data, {});
+}
+
+void file_map::free(std::span<const std::byte> data)
+{
+    if (data.empty())
+        return;
+
+#ifdef HAL_FILE_MAP_MMAP
+    ::munmap(const_cast<std::byte*>(data.data()), data.size());
+#else
+    delete[] data.data();
+#endif
+}
\ No newline at end of file
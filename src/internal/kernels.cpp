@@ -0,0 +1,500 @@
+#include <halcyon/internal/kernels.hpp>
+
+#include <atomic>
+
+#include <halcyon/debug.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HAL_KERNELS_X86
+
+    #include <immintrin.h>
+
+    #ifdef _MSC_VER
+        #include <intrin.h>
+
+        #define HAL_TARGET_AVX2
+    #else
+        #define HAL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+using namespace hal;
+using namespace hal::detail;
+
+// Every kernel is an operation on a single 32-bit pixel value, plus optional vectorized
+// versions that process as many pixels of a row as they can and return how many that was.
+// The scalar version handles whatever is left over.
+
+namespace
+{
+    kernels::isa detect_isa()
+    {
+#ifdef HAL_KERNELS_X86
+    #ifdef _MSC_VER
+        int info[4];
+
+        ::__cpuid(info, 0);
+
+        if (info[0] >= 7)
+        {
+            ::__cpuid(info, 1);
+
+            // The OS must also save YMM registers on context switches.
+            const bool osxsave { (info[2] & (1 << 27)) != 0 };
+
+            ::__cpuidex(info, 7, 0);
+
+            if (osxsave && (info[1] & (1 << 5)) != 0 && (::_xgetbv(0) & 0x6) == 0x6)
+                return kernels::isa::avx2;
+        }
+    #else
+        if (__builtin_cpu_supports("avx2"))
+            return kernels::isa::avx2;
+    #endif
+
+        return kernels::isa::sse2;
+#else
+        return kernels::isa::scalar;
+#endif
+    }
+
+    const kernels::isa supported { detect_isa() };
+
+    // Read by kernels running on thread pool workers, so changes must be atomic.
+    // Nothing else is published through it, so relaxed ordering will do.
+    std::atomic<kernels::isa> active { supported };
+
+    // x * y / 255, rounded.
+    constexpr u32 mul255(u32 x, u32 y)
+    {
+        const u32 t { x * y + 128 };
+        return (t + (t >> 8)) >> 8;
+    }
+
+    template <typename Op>
+    void run(const kernels::image& img, const Op& op)
+    {
+        const std::size_t width { static_cast<std::size_t>(img.size.x) };
+
+#ifdef HAL_KERNELS_X86
+        const kernels::isa set { active.load(std::memory_order_relaxed) };
+#endif
+
+        for (pixel_t y { 0 }; y < img.size.y; ++y)
+        {
+            u32* const  row { img.row(y) };
+            std::size_t x { 0 };
+
+#ifdef HAL_KERNELS_X86
+            if (set == kernels::isa::avx2)
+                x = op.avx2(row, width);
+
+            else if (set == kernels::isa::sse2)
+                x = op.sse2(row, width);
+#endif
+
+            for (; x < width; ++x)
+                row[x] = op(row[x]);
+        }
+    }
+
+#ifdef HAL_KERNELS_X86
+    // Shared vector helpers.
+
+    // Multiply 8-bit lanes of two vectors, treating them as fractions of 255.
+    __m128i mul255_sse2(__m128i px, __m128i factor)
+    {
+        const __m128i zero { _mm_setzero_si128() }, bias { _mm_set1_epi16(128) };
+
+        __m128i lo { _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(factor, zero)), bias) };
+        __m128i hi { _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(factor, zero)), bias) };
+
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    HAL_TARGET_AVX2 __m256i mul255_avx2(__m256i px, __m256i factor)
+    {
+        const __m256i zero { _mm256_setzero_si256() }, bias { _mm256_set1_epi16(128) };
+
+        __m256i lo { _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(px, zero), _mm256_unpacklo_epi8(factor, zero)), bias) };
+        __m256i hi { _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(px, zero), _mm256_unpackhi_epi8(factor, zero)), bias) };
+
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        return _mm256_packus_epi16(lo, hi);
+    }
+
+    // Extract an 8-bit channel into the low byte of each 32-bit lane.
+    __m128i channel_sse2(__m128i px, u8 shift)
+    {
+        return _mm_and_si128(_mm_srl_epi32(px, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF));
+    }
+
+    HAL_TARGET_AVX2 __m256i channel_avx2(__m256i px, u8 shift)
+    {
+        return _mm256_and_si256(_mm256_srl_epi32(px, _mm_cvtsi32_si128(shift)), _mm256_set1_epi32(0xFF));
+    }
+
+    // Load/store wrappers.
+    __m128i load_sse2(const u32* ptr)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    }
+
+    void store_sse2(u32* ptr, __m128i v)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v);
+    }
+
+    HAL_TARGET_AVX2 __m256i load_avx2(const u32* ptr)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+
+    HAL_TARGET_AVX2 void store_avx2(u32* ptr, __m256i v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), v);
+    }
+#endif
+
+    // Flip all color bits.
+    struct invert_op
+    {
+        u32 mask;
+
+        u32 operator()(u32 px) const
+        {
+            return px ^ mask;
+        }
+
+#ifdef HAL_KERNELS_X86
+        std::size_t sse2(u32* row, std::size_t n) const
+        {
+            const __m128i m { _mm_set1_epi32(static_cast<int>(mask)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 4 <= n; i += 4)
+                store_sse2(row + i, _mm_xor_si128(load_sse2(row + i), m));
+
+            return i;
+        }
+
+        HAL_TARGET_AVX2 std::size_t avx2(u32* row, std::size_t n) const
+        {
+            const __m256i m { _mm256_set1_epi32(static_cast<int>(mask)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 8 <= n; i += 8)
+                store_avx2(row + i, _mm256_xor_si256(load_avx2(row + i), m));
+
+            return i;
+        }
+#endif
+    };
+
+    // Multiply every channel by a constant factor.
+    struct multiply_op
+    {
+        u32 factor;
+
+        u32 operator()(u32 px) const
+        {
+            u32 ret { 0 };
+
+            for (u8 shift { 0 }; shift < 32; shift += 8)
+                ret |= mul255((px >> shift) & 0xFF, (factor >> shift) & 0xFF) << shift;
+
+            return ret;
+        }
+
+#ifdef HAL_KERNELS_X86
+        std::size_t sse2(u32* row, std::size_t n) const
+        {
+            const __m128i f { _mm_set1_epi32(static_cast<int>(factor)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 4 <= n; i += 4)
+                store_sse2(row + i, mul255_sse2(load_sse2(row + i), f));
+
+            return i;
+        }
+
+        HAL_TARGET_AVX2 std::size_t avx2(u32* row, std::size_t n) const
+        {
+            const __m256i f { _mm256_set1_epi32(static_cast<int>(factor)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 8 <= n; i += 8)
+                store_avx2(row + i, mul255_avx2(load_avx2(row + i), f));
+
+            return i;
+        }
+#endif
+    };
+
+    // Multiply color channels by alpha.
+    struct premultiply_op
+    {
+        kernels::layout fmt;
+
+        u32 operator()(u32 px) const
+        {
+            const u32 alpha { (px >> fmt.a) & 0xFF };
+
+            u32 ret { px & (0xFFu << fmt.a) };
+
+            for (const u8 shift : { fmt.r, fmt.g, fmt.b })
+                ret |= mul255((px >> shift) & 0xFF, alpha) << shift;
+
+            return ret;
+        }
+
+#ifdef HAL_KERNELS_X86
+        std::size_t sse2(u32* row, std::size_t n) const
+        {
+            const __m128i amask { _mm_set1_epi32(static_cast<int>(0xFFu << fmt.a)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128i px { load_sse2(row + i) };
+
+                // Broadcast alpha to every byte, then force the alpha byte's own factor to 255.
+                __m128i f { channel_sse2(px, fmt.a) };
+                f = _mm_or_si128(f, _mm_slli_epi32(f, 8));
+                f = _mm_or_si128(f, _mm_slli_epi32(f, 16));
+                f = _mm_or_si128(f, amask);
+
+                store_sse2(row + i, mul255_sse2(px, f));
+            }
+
+            return i;
+        }
+
+        HAL_TARGET_AVX2 std::size_t avx2(u32* row, std::size_t n) const
+        {
+            const __m256i amask { _mm256_set1_epi32(static_cast<int>(0xFFu << fmt.a)) };
+
+            std::size_t i { 0 };
+
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256i px { load_avx2(row + i) };
+
+                __m256i f { channel_avx2(px, fmt.a) };
+                f = _mm256_or_si256(f, _mm256_slli_epi32(f, 8));
+                f = _mm256_or_si256(f, _mm256_slli_epi32(f, 16));
+                f = _mm256_or_si256(f, amask);
+
+                store_avx2(row + i, mul255_avx2(px, f));
+            }
+
+            return i;
+        }
+#endif
+    };
+
+    // Replace color channels with Rec. 601 luma. Weights sum up to 256.
+    struct grayscale_op
+    {
+        static constexpr u32 wr { 77 }, wg { 150 }, wb { 29 };
+
+        kernels::layout fmt;
+
+        u32 operator()(u32 px) const
+        {
+            const u32 y { (((px >> fmt.r) & 0xFF) * wr + ((px >> fmt.g) & 0xFF) * wg + ((px >> fmt.b) & 0xFF) * wb + 128) >> 8 };
+
+            return (px & (0xFFu << fmt.a)) | (y << fmt.r) | (y << fmt.g) | (y << fmt.b);
+        }
+
+#ifdef HAL_KERNELS_X86
+        // Channels are at most 255 and the weighted sum at most 65280, so 16-bit multiplies
+        // of zero-extended 32-bit lanes never lose bits.
+        std::size_t sse2(u32* row, std::size_t n) const
+        {
+            const __m128i amask { _mm_set1_epi32(static_cast<int>(0xFFu << fmt.a)) }, bias { _mm_set1_epi32(128) };
+            const __m128i r { _mm_set1_epi32(wr) }, g { _mm_set1_epi32(wg) }, b { _mm_set1_epi32(wb) };
+
+            std::size_t i { 0 };
+
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128i px { load_sse2(row + i) };
+
+                __m128i y { _mm_add_epi32(_mm_mullo_epi16(channel_sse2(px, fmt.r), r), _mm_mullo_epi16(channel_sse2(px, fmt.g), g)) };
+                y = _mm_add_epi32(y, _mm_mullo_epi16(channel_sse2(px, fmt.b), b));
+                y = _mm_srli_epi32(_mm_add_epi32(y, bias), 8);
+
+                __m128i out { _mm_and_si128(px, amask) };
+                out = _mm_or_si128(out, _mm_sll_epi32(y, _mm_cvtsi32_si128(fmt.r)));
+                out = _mm_or_si128(out, _mm_sll_epi32(y, _mm_cvtsi32_si128(fmt.g)));
+                out = _mm_or_si128(out, _mm_sll_epi32(y, _mm_cvtsi32_si128(fmt.b)));
+
+                store_sse2(row + i, out);
+            }
+
+            return i;
+        }
+
+        HAL_TARGET_AVX2 std::size_t avx2(u32* row, std::size_t n) const
+        {
+            const __m256i amask { _mm256_set1_epi32(static_cast<int>(0xFFu << fmt.a)) }, bias { _mm256_set1_epi32(128) };
+            const __m256i r { _mm256_set1_epi32(wr) }, g { _mm256_set1_epi32(wg) }, b { _mm256_set1_epi32(wb) };
+
+            std::size_t i { 0 };
+
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256i px { load_avx2(row + i) };
+
+                __m256i y { _mm256_add_epi32(_mm256_mullo_epi16(channel_avx2(px, fmt.r), r), _mm256_mullo_epi16(channel_avx2(px, fmt.g), g)) };
+                y = _mm256_add_epi32(y, _mm256_mullo_epi16(channel_avx2(px, fmt.b), b));
+                y = _mm256_srli_epi32(_mm256_add_epi32(y, bias), 8);
+
+                __m256i out { _mm256_and_si256(px, amask) };
+                out = _mm256_or_si256(out, _mm256_sll_epi32(y, _mm_cvtsi32_si128(fmt.r)));
+                out = _mm256_or_si256(out, _mm256_sll_epi32(y, _mm_cvtsi32_si128(fmt.g)));
+                out = _mm256_or_si256(out, _mm256_sll_epi32(y, _mm_cvtsi32_si128(fmt.b)));
+
+                store_avx2(row + i, out);
+            }
+
+            return i;
+        }
+#endif
+    };
+
+    // Move channels around.
+    struct swizzle_op
+    {
+        std::array<u8, 4> from, to; // Source and destination shifts, per channel.
+
+        u32 operator()(u32 px) const
+        {
+            u32 ret { 0 };
+
+            for (std::size_t c { 0 }; c < 4; ++c)
+                ret |= ((px >> from[c]) & 0xFF) << to[c];
+
+            return ret;
+        }
+
+#ifdef HAL_KERNELS_X86
+        std::size_t sse2(u32* row, std::size_t n) const
+        {
+            std::size_t i { 0 };
+
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128i px { load_sse2(row + i) };
+
+                __m128i out { _mm_setzero_si128() };
+
+                for (std::size_t c { 0 }; c < 4; ++c)
+                    out = _mm_or_si128(out, _mm_sll_epi32(channel_sse2(px, from[c]), _mm_cvtsi32_si128(to[c])));
+
+                store_sse2(row + i, out);
+            }
+
+            return i;
+        }
+
+        HAL_TARGET_AVX2 std::size_t avx2(u32* row, std::size_t n) const
+        {
+            std::size_t i { 0 };
+
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256i px { load_avx2(row + i) };
+
+                __m256i out { _mm256_setzero_si256() };
+
+                for (std::size_t c { 0 }; c < 4; ++c)
+                    out = _mm256_or_si256(out, _mm256_sll_epi32(channel_avx2(px, from[c]), _mm_cvtsi32_si128(to[c])));
+
+                store_avx2(row + i, out);
+            }
+
+            return i;
+        }
+#endif
+    };
+}
+
+kernels::image kernels::image_of(SDL_Surface* surf)
+{
+    const SDL_PixelFormat* const fmt { surf->format };
+
+    HAL_ASSERT(fmt->BytesPerPixel == 4 && fmt->Amask != 0, "Bulk pixel operations require a 32-bit format with alpha");
+    HAL_ASSERT(fmt->Rloss == 0 && fmt->Gloss == 0 && fmt->Bloss == 0 && fmt->Aloss == 0, "Bulk pixel operations require 8-bit channels");
+    HAL_ASSERT(!SDL_MUSTLOCK(surf), "Bulk pixel operations don't support RLE surfaces");
+
+    return {
+        static_cast<std::byte*>(surf->pixels),
+        surf->pitch,
+        { static_cast<pixel_t>(surf->w), static_cast<pixel_t>(surf->h) },
+        { fmt->Rshift, fmt->Gshift, fmt->Bshift, fmt->Ashift }
+    };
+}
+
+kernels::isa kernels::supported_isa()
+{
+    return supported;
+}
+
+kernels::isa kernels::active_isa()
+{
+    return active.load(std::memory_order_relaxed);
+}
+
+void kernels::restrict_isa(isa set)
+{
+    active.store(std::min(set, supported), std::memory_order_relaxed);
+}
+
+void kernels::invert(const image& img)
+{
+    run(img, invert_op { ~(0xFFu << img.fmt.a) });
+}
+
+void kernels::multiply(const image& img, color c)
+{
+    run(img, multiply_op { img.fmt.pack(c) });
+}
+
+void kernels::premultiply(const image& img)
+{
+    run(img, premultiply_op { img.fmt });
+}
+
+void kernels::grayscale(const image& img)
+{
+    run(img, grayscale_op { img.fmt });
+}
+
+void kernels::swizzle(const image& img, std::array<u8, 4> src)
+{
+    const std::array<u8, 4> shifts { img.fmt.r, img.fmt.g, img.fmt.b, img.fmt.a };
+
+    swizzle_op op;
+
+    for (std::size_t c { 0 }; c < 4; ++c)
+    {
+        HAL_ASSERT(src[c] < 4, "Invalid swizzle channel");
+
+        op.from[c] = shifts[src[c]];
+        op.to[c]   = shifts[c];
+    }
+
+    run(img, op);
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <halcyon/debug.hpp>
+
+#ifdef HAL_DEBUG_ENABLED
+
+    #include <atomic>
+    #include <memory>
+    #include <spanstream>
+    #include <thread>
+    #include <utility>
+
+    #ifdef HAL_DEBUG_ADVANCED
+        #include <fstream>
+    #endif
+
+using namespace hal;
+using namespace hal::detail;
+
+namespace
+{
+    #ifdef HAL_DEBUG_ADVANCED
+    // Timestamps are relative to program startup.
+    const log::clock::time_point epoch { log::clock::now() };
+    #endif
+
+    // A bounded MPSC queue in the style of Dmitry Vyukov's: each slot carries a sequence
+    // number that tells producers and the consumer whose turn it is, so claiming a slot
+    // takes a single compare-and-swap and nothing ever blocks on a lock.
+    class log_queue
+    {
+    public:
+        log_queue()
+            : m_slots { std::make_unique<slot[]>(capacity) }
+        {
+            for (std::size_t i { 0 }; i < capacity; ++i)
+                m_slots[i].seq.store(i, std::memory_order_relaxed);
+
+            m_thread = std::jthread { [this](std::stop_token stop)
+                { consume(stop); } };
+        }
+
+        void push(const log::header& hdr, std::span<const std::byte> payload)
+        {
+            u64 pos { m_enqueue.load(std::memory_order_relaxed) };
+
+            slot* s;
+
+            while (true)
+            {
+                s = &m_slots[pos % capacity];
+
+                const i64 diff { static_cast<i64>(s->seq.load(std::memory_order_acquire) - pos) };
+
+                if (diff == 0)
+                {
+                    if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+
+                // Full; wait for the consumer to catch up.
+                else if (diff < 0)
+                {
+                    std::this_thread::yield();
+                    pos = m_enqueue.load(std::memory_order_relaxed);
+                }
+
+                else
+                    pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+
+            s->hdr  = hdr;
+            std::memcpy(s->payload.data(), payload.data(), payload.size());
+
+            s->seq.store(pos + 1, std::memory_order_release);
+        }
+
+        void flush()
+        {
+            const u64 target { m_enqueue.load(std::memory_order_acquire) };
+
+            while (m_done.load(std::memory_order_acquire) < target)
+                std::this_thread::yield();
+        }
+
+    private:
+        static constexpr std::size_t capacity { 1024 };
+
+        struct slot
+        {
+            std::atomic<u64> seq;
+
+            log::header                              hdr;
+            std::array<std::byte, log::payload_size> payload;
+        };
+
+        void consume(std::stop_token stop)
+        {
+            using namespace std::chrono_literals;
+
+            std::array<char, 2048> buffer;
+
+            u64  pos { 0 };
+            bool written { false };
+
+            while (true)
+            {
+                slot& s { m_slots[pos % capacity] };
+
+                if (s.seq.load(std::memory_order_acquire) != pos + 1)
+                {
+                    // Drained: make everything visible before reporting progress.
+                    if (std::exchange(written, false))
+                    {
+                        std::cout.flush();
+                        std::cerr.flush();
+
+    #ifdef HAL_DEBUG_ADVANCED
+                        m_output.flush();
+    #endif
+                    }
+
+                    m_done.store(pos, std::memory_order_release);
+
+                    if (stop.stop_requested() && m_enqueue.load(std::memory_order_acquire) == pos)
+                        return;
+
+                    std::this_thread::sleep_for(1ms);
+                    continue;
+                }
+
+                // A fresh stream per record, so that manipulators don't leak into the next one.
+                std::ospanstream line { std::span { buffer.data(), buffer.size() - 1 } };
+
+    #ifdef HAL_DEBUG_ADVANCED
+                const auto ms { std::chrono::duration_cast<std::chrono::milliseconds>(s.hdr.time - epoch).count() };
+
+                line << '[' << ms / 1000 << '.' << static_cast<char>('0' + ms / 100 % 10) << static_cast<char>('0' + ms / 10 % 10) << static_cast<char>('0' + ms % 10) << "s] ";
+    #endif
+
+                line << s.hdr.prefix;
+                s.hdr.fmt(line, s.payload.data());
+
+                // Overlong lines get cut off, but always end.
+                const std::size_t len { line.span().size() };
+                buffer[len] = '\n';
+
+    #ifdef HAL_DEBUG_ADVANCED
+                m_output.write(buffer.data(), len + 1);
+    #endif
+
+                (s.hdr.error ? std::cerr : std::cout).write(buffer.data(), len + 1);
+
+                written = true;
+
+                s.seq.store(pos + capacity, std::memory_order_release);
+                ++pos;
+            }
+        }
+
+        std::unique_ptr<slot[]> m_slots;
+
+        std::atomic<u64> m_enqueue { 0 }, m_done { 0 };
+
+    #ifdef HAL_DEBUG_ADVANCED
+        std::ofstream m_output { "Halcyon Debug Output.txt" };
+    #endif
+
+        // Declared last, so that it's joined before anything it uses is destroyed.
+        std::jthread m_thread;
+    };
+
+    log_queue& queue()
+    {
+        static log_queue q;
+        return q;
+    }
+}
+
+std::span<std::byte, log::payload_size> log::local_buffer()
+{
+    thread_local std::array<std::byte, payload_size> buf;
+    return buf;
+}
+
+void log::push(const header& hdr, std::span<const std::byte> payload)
+{
+    queue().push(hdr, payload);
+}
+
+void log::flush()
+{
+    queue().flush();
+}
+
+#endif
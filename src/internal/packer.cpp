@@ -0,0 +1,101 @@
+#include <halcyon/internal/packer.hpp>
+
+#include <limits>
+
+using namespace hal;
+
+detail::skyline::skyline(pixel::point size)
+    : m_size { size }
+{
+    clear();
+}
+
+std::optional<pixel::point> detail::skyline::insert(pixel::point size)
+{
+    if (size.x <= 0 || size.y <= 0 || size.x > m_size.x || size.y > m_size.y)
+        return std::nullopt;
+
+    constexpr std::size_t none { std::numeric_limits<std::size_t>::max() };
+
+    std::size_t best { none };
+    pixel_t     best_y { std::numeric_limits<pixel_t>::max() }, best_width { std::numeric_limits<pixel_t>::max() };
+
+    for (std::size_t i { 0 }; i < m_nodes.size(); ++i)
+    {
+        // Nodes are sorted by X and cover the entire width, so nothing past this point fits.
+        if (m_nodes[i].x + size.x > m_size.x)
+            break;
+
+        // The rectangle rests on the highest node it spans.
+        pixel_t y { 0 };
+        bool    fits { true };
+
+        for (std::size_t j { i }; j < m_nodes.size() && m_nodes[j].x < m_nodes[i].x + size.x; ++j)
+        {
+            y = std::max(y, m_nodes[j].y);
+
+            if (y + size.y > m_size.y)
+            {
+                fits = false;
+                break;
+            }
+        }
+
+        if (fits && (y < best_y || (y == best_y && m_nodes[i].width < best_width)))
+        {
+            best       = i;
+            best_y     = y;
+            best_width = m_nodes[i].width;
+        }
+    }
+
+    if (best == none)
+        return std::nullopt;
+
+    const pixel::point pos { m_nodes[best].x, best_y };
+
+    m_nodes.insert(m_nodes.begin() + best, node { pos.x, static_cast<pixel_t>(pos.y + size.y), size.x });
+
+    // Trim the nodes now covered by the new one.
+    for (std::size_t i { best + 1 }; i < m_nodes.size();)
+    {
+        const node& prev { m_nodes[i - 1] };
+        const pixel_t overlap { prev.x + prev.width - m_nodes[i].x };
+
+        if (overlap <= 0)
+            break;
+
+        m_nodes[i].x += overlap;
+        m_nodes[i].width -= overlap;
+
+        if (m_nodes[i].width > 0)
+            break;
+
+        m_nodes.erase(m_nodes.begin() + i);
+    }
+
+    // Merge neighbours of the same height.
+    for (std::size_t i { 0 }; i + 1 < m_nodes.size();)
+    {
+        if (m_nodes[i].y == m_nodes[i + 1].y)
+        {
+            m_nodes[i].width += m_nodes[i + 1].width;
+            m_nodes.erase(m_nodes.begin() + i + 1);
+        }
+
+        else
+            ++i;
+    }
+
+    return pos;
+}
+
+void detail::skyline::clear()
+{
+    m_nodes.assign(1, node { 0, 0, m_size.x });
+}
+
+pixel::point detail::skyline::size() const
+{
+    return m_size;
+}
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include <halcyon/internal/resample.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <halcyon/internal/kernels.hpp>
+
+#include <halcyon/utility/thread_pool.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HAL_RESAMPLE_SSE2
+
+    #include <emmintrin.h>
+#endif
+
+using namespace hal;
+using namespace hal::detail;
+
+// A two-pass (horizontal, then vertical) resampler in the spirit of Pillow's.
+// Each output pixel is a weighted sum of a run of input pixels; the weights depend only
+// on the output pixel's position, so they're computed once per axis and quantized to
+// fixed-point, which lets the inner loop run on 16-bit multiply-adds.
+
+namespace
+{
+    // Fractional bits of the fixed-point weights.
+    constexpr int precision { 14 };
+
+    f64 box(f64 x)
+    {
+        return x >= -0.5 && x < 0.5 ? 1.0 : 0.0;
+    }
+
+    f64 triangle(f64 x)
+    {
+        x = std::abs(x);
+        return x < 1.0 ? 1.0 - x : 0.0;
+    }
+
+    // Keys' cubic with a = -0.5 (Catmull-Rom).
+    f64 cubic(f64 x)
+    {
+        constexpr f64 a { -0.5 };
+
+        x = std::abs(x);
+
+        if (x < 1.0)
+            return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+
+        if (x < 2.0)
+            return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+
+        return 0.0;
+    }
+
+    f64 sinc(f64 x)
+    {
+        if (x == 0.0)
+            return 1.0;
+
+        x *= std::numbers::pi;
+        return std::sin(x) / x;
+    }
+
+    f64 lanczos3(f64 x)
+    {
+        return x > -3.0 && x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+    }
+
+    struct kernel
+    {
+        f64 (*func)(f64);
+        f64 support;
+    };
+
+    kernel kernel_of(filter f)
+    {
+        switch (f)
+        {
+        case filter::box:
+            return { box, 0.5 };
+
+        case filter::bilinear:
+            return { triangle, 1.0 };
+
+        case filter::bicubic:
+            return { cubic, 2.0 };
+
+        case filter::lanczos3:
+            return { lanczos3, 3.0 };
+
+        default:
+            HAL_PANIC("Unsupported resampling filter");
+        }
+    }
+
+    // Which input pixels contribute to each output pixel, and by how much.
+    struct weight_table
+    {
+        std::vector<int> start, count;
+        std::vector<i16> weights; // Fixed stride of [taps] per output pixel.
+        int              taps;
+
+        const i16* at(std::size_t idx) const
+        {
+            return weights.data() + idx * taps;
+        }
+    };
+
+    weight_table make_table(pixel_t in, pixel_t out, kernel k)
+    {
+        // When downscaling, the filter is stretched to cover every input pixel.
+        const f64 scale { static_cast<f64>(in) / out };
+        const f64 filter_scale { std::max(scale, 1.0) };
+        const f64 support { k.support * filter_scale };
+
+        weight_table ret;
+
+        ret.taps = static_cast<int>(std::ceil(support)) * 2 + 1;
+        ret.start.resize(out);
+        ret.count.resize(out);
+        ret.weights.assign(static_cast<std::size_t>(out) * ret.taps, 0);
+
+        std::vector<f64> w(ret.taps);
+
+        for (pixel_t i { 0 }; i < out; ++i)
+        {
+            const f64 center { (i + 0.5) * scale };
+            const int first { std::max(static_cast<int>(center - support + 0.5), 0) };
+            const int last { std::min(static_cast<int>(center + support + 0.5), static_cast<int>(in)) };
+            const int n { std::min(last - first, ret.taps) };
+
+            f64 sum { 0.0 };
+
+            for (int j { 0 }; j < n; ++j)
+            {
+                w[j] = k.func((first + j - center + 0.5) / filter_scale);
+                sum += w[j];
+            }
+
+            if (sum == 0.0)
+                sum = 1.0;
+
+            // Quantize, then hand the rounding error to the largest weight so that
+            // weights always sum up to exactly one - flat areas must stay flat.
+            i16* const dst { ret.weights.data() + static_cast<std::size_t>(i) * ret.taps };
+
+            int total { 0 }, largest { 0 };
+
+            for (int j { 0 }; j < n; ++j)
+            {
+                dst[j] = static_cast<i16>(std::lround(w[j] / sum * (1 << precision)));
+                total += dst[j];
+
+                if (dst[j] > dst[largest])
+                    largest = j;
+            }
+
+            dst[largest] = static_cast<i16>(dst[largest] + (1 << precision) - total);
+
+            ret.start[i] = first;
+            ret.count[i] = n;
+        }
+
+        return ret;
+    }
+
+    // Weighted sum of [n] pixels, [stride] pixels apart. Channels are treated alike.
+    u32 sample_scalar(const u32* px, std::ptrdiff_t stride, const i16* w, int n)
+    {
+        i32 acc[4] { 1 << (precision - 1), 1 << (precision - 1), 1 << (precision - 1), 1 << (precision - 1) };
+
+        for (int k { 0 }; k < n; ++k)
+        {
+            const u32 p { px[k * stride] };
+
+            for (int c { 0 }; c < 4; ++c)
+                acc[c] += static_cast<i32>((p >> (c * 8)) & 0xFF) * w[k];
+        }
+
+        u32 ret { 0 };
+
+        for (int c { 0 }; c < 4; ++c)
+            ret |= static_cast<u32>(std::clamp(acc[c] >> precision, 0, 255)) << (c * 8);
+
+        return ret;
+    }
+
+#ifdef HAL_RESAMPLE_SSE2
+    // Pairs of taps are interleaved channel by channel, so that a single
+    // multiply-add applies both weights and sums them up.
+    u32 sample_sse2(const u32* px, std::ptrdiff_t stride, const i16* w, int n)
+    {
+        const __m128i zero { _mm_setzero_si128() };
+
+        __m128i acc { _mm_set1_epi32(1 << (precision - 1)) };
+
+        int k { 0 };
+
+        for (; k + 1 < n; k += 2)
+        {
+            const __m128i a { _mm_cvtsi32_si128(static_cast<int>(px[k * stride])) };
+            const __m128i b { _mm_cvtsi32_si128(static_cast<int>(px[(k + 1) * stride])) };
+
+            const __m128i weights { _mm_set1_epi32(static_cast<int>(static_cast<u16>(w[k]) | (static_cast<u32>(static_cast<u16>(w[k + 1])) << 16))) };
+
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(a, b), zero), weights));
+        }
+
+        if (k < n)
+        {
+            const __m128i a { _mm_cvtsi32_si128(static_cast<int>(px[k * stride])) };
+
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(_mm_unpacklo_epi8(a, zero), zero), _mm_set1_epi32(static_cast<u16>(w[k]))));
+        }
+
+        acc = _mm_srai_epi32(acc, precision);
+        acc = _mm_packs_epi32(acc, acc);
+        acc = _mm_packus_epi16(acc, acc);
+
+        return static_cast<u32>(_mm_cvtsi128_si32(acc));
+    }
+#endif
+
+    // Undo alpha premultiplication.
+    void unpremultiply(u32* row, pixel_t width, const kernels::layout& fmt)
+    {
+        for (pixel_t x { 0 }; x < width; ++x)
+        {
+            const u32 a { (row[x] >> fmt.a) & 0xFF };
+
+            if (a == 0 || a == 0xFF)
+                continue;
+
+            u32 px { row[x] & (0xFFu << fmt.a) };
+
+            for (const u8 shift : { fmt.r, fmt.g, fmt.b })
+                px |= std::min((((row[x] >> shift) & 0xFF) * 0xFF + a / 2) / a, 0xFFu) << shift;
+
+            row[x] = px;
+        }
+    }
+
+    kernels::image band_of(const kernels::image& img, pixel_t begin, pixel_t end)
+    {
+        return { img.pixels + begin * img.pitch, img.pitch, { img.size.x, static_cast<pixel_t>(end - begin) }, img.fmt };
+    }
+}
+
+surface detail::resample(view<const surface> src, pixel::point size, filter f, thread_pool* pool)
+{
+    HAL_ASSERT(size.x > 0 && size.y > 0, "Invalid resampling size");
+
+    const kernel k { kernel_of(f) };
+
+    auto sample = sample_scalar;
+
+#ifdef HAL_RESAMPLE_SSE2
+    if (kernels::active_isa() != kernels::isa::scalar)
+        sample = sample_sse2;
+#endif
+
+    const auto bands = [pool](view<const surface> surf, const std::function<void(pixel_t, pixel_t)>& func)
+    {
+        if (pool != nullptr)
+            surf.for_each_band(*pool, func);
+
+        else
+            func(0, surf.size().y);
+    };
+
+    // Work on a premultiplied copy.
+    const surface work { pool != nullptr ? src.convert(surface::default_pixel_format, *pool) : src.convert(surface::default_pixel_format) };
+
+    const kernels::image in { kernels::image_of(work.get()) };
+
+    bands(work, [&](pixel_t begin, pixel_t end)
+        { kernels::premultiply(band_of(in, begin, end)); });
+
+    const weight_table horz { make_table(in.size.x, size.x, k) }, vert { make_table(in.size.y, size.y, k) };
+
+    // Horizontal pass.
+    const surface        mid { { size.x, in.size.y } };
+    const kernels::image mi { kernels::image_of(mid.get()) };
+
+    bands(mid, [&](pixel_t begin, pixel_t end)
+        {
+            for (pixel_t y { begin }; y < end; ++y)
+            {
+                const u32* const row { in.row(y) };
+                u32* const       out { mi.row(y) };
+
+                for (pixel_t x { 0 }; x < size.x; ++x)
+                    out[x] = sample(row + horz.start[x], 1, horz.at(x), horz.count[x]);
+            }
+        });
+
+    // Vertical pass.
+    surface              ret { size };
+    const kernels::image ri { kernels::image_of(ret.get()) };
+
+    const std::ptrdiff_t stride { mi.pitch / static_cast<std::ptrdiff_t>(sizeof(u32)) };
+
+    bands(ret, [&](pixel_t begin, pixel_t end)
+        {
+            for (pixel_t y { begin }; y < end; ++y)
+            {
+                const u32* const first { mi.row(vert.start[y]) };
+                const i16* const w { vert.at(y) };
+                u32* const       out { ri.row(y) };
+
+                for (pixel_t x { 0 }; x < size.x; ++x)
+                    out[x] = sample(first + x, stride, w, vert.count[y]);
+
+                unpremultiply(out, size.x, ri.fmt);
+            }
+        });
+
+    return ret;
+}
\ No newline at end of file
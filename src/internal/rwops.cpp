@@ -1,7 +1,305 @@
 #include <halcyon/internal/rwops.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include <halcyon/internal/file_map.hpp>
+
+#include <halcyon/utility/output_buffer.hpp>
+
 using namespace hal;
 
+namespace
+{
+    // The state behind a stream RWops. The buffer holds the stream's bytes from
+    // [m_start] to [m_start + m_filled]; [m_pos] is where the RWops is at.
+    class adapter
+    {
+    public:
+        adapter(std::unique_ptr<detail::stream> s, std::size_t read_ahead)
+            : m_stream { std::move(s) }
+            , m_buffer { read_ahead > 0 ? std::make_unique<std::byte[]>(read_ahead) : nullptr }
+            , m_capacity { read_ahead }
+        {
+        }
+
+        std::size_t read(std::span<std::byte> dst)
+        {
+            std::size_t total { 0 };
+
+            while (!dst.empty())
+            {
+                // Serve what's buffered.
+                if (m_pos < m_start + static_cast<i64>(m_filled))
+                {
+                    const std::size_t offset { static_cast<std::size_t>(m_pos - m_start) };
+                    const std::size_t amount { std::min(dst.size(), m_filled - offset) };
+
+                    std::memcpy(dst.data(), m_buffer.get() + offset, amount);
+
+                    advance(dst, total, amount);
+                    continue;
+                }
+
+                std::size_t got;
+
+                // Large reads skip the buffer entirely.
+                if (dst.size() >= m_capacity)
+                {
+                    got = m_stream->read(dst);
+
+                    m_start  = m_pos + static_cast<i64>(got);
+                    m_filled = 0;
+
+                    advance(dst, total, got);
+                }
+
+                // Keep what's buffered for as long as there's room, so seeking back still works.
+                else
+                {
+                    if (m_filled == m_capacity)
+                    {
+                        m_start  = m_pos;
+                        m_filled = 0;
+                    }
+
+                    got = m_stream->read({ m_buffer.get() + m_filled, m_capacity - m_filled });
+                    m_filled += got;
+                }
+
+                if (got == 0)
+                    break;
+            }
+
+            return total;
+        }
+
+        std::size_t write(std::span<const std::byte> src)
+        {
+            const std::size_t written { m_stream->write(src) };
+
+            m_pos += static_cast<i64>(written);
+
+            m_start  = m_pos;
+            m_filled = 0;
+
+            return written;
+        }
+
+        i64 seek(i64 offset, seek_origin origin)
+        {
+            i64 target;
+
+            switch (origin)
+            {
+            case seek_origin::begin:
+                target = offset;
+                break;
+
+            case seek_origin::current:
+                target = m_pos + offset;
+                break;
+
+            case seek_origin::end:
+            {
+                const i64 sz { m_stream->size() };
+
+                if (sz < 0)
+                    return ::SDL_SetError("Stream size unknown, cannot seek from its end");
+
+                target = sz + offset;
+            }
+            break;
+
+            default:
+                return ::SDL_SetError("Invalid seek origin");
+            }
+
+            // Within the buffer (or telling the position): no need to bother the stream.
+            if (target >= m_start && target <= m_start + static_cast<i64>(m_filled))
+                return m_pos = target;
+
+            const i64 res { m_stream->seek(target, seek_origin::begin) };
+
+            if (res < 0)
+                return ::SDL_SetError("Stream is not seekable");
+
+            m_pos = m_start = res;
+            m_filled        = 0;
+
+            return m_pos;
+        }
+
+        i64 size()
+        {
+            return m_stream->size();
+        }
+
+    private:
+        void advance(std::span<std::byte>& dst, std::size_t& total, std::size_t amount)
+        {
+            dst = dst.subspan(amount);
+            total += amount;
+            m_pos += static_cast<i64>(amount);
+        }
+
+        std::unique_ptr<detail::stream> m_stream;
+
+        std::unique_ptr<std::byte[]> m_buffer;
+        std::size_t                  m_capacity, m_filled { 0 };
+
+        i64 m_start { 0 }, m_pos { 0 };
+    };
+
+    adapter& adapter_of(SDL_RWops* ctx)
+    {
+        return *static_cast<adapter*>(ctx->hidden.unknown.data1);
+    }
+
+    // Like SDL's own RWops, these count whole objects.
+    std::size_t adapter_read(SDL_RWops* ctx, void* ptr, std::size_t size, std::size_t maxnum)
+    {
+        return size == 0 ? 0 : adapter_of(ctx).read({ static_cast<std::byte*>(ptr), size * maxnum }) / size;
+    }
+
+    std::size_t adapter_write(SDL_RWops* ctx, const void* ptr, std::size_t size, std::size_t num)
+    {
+        return size == 0 ? 0 : adapter_of(ctx).write({ static_cast<const std::byte*>(ptr), size * num }) / size;
+    }
+
+    Sint64 adapter_seek(SDL_RWops* ctx, Sint64 offset, int whence)
+    {
+        return adapter_of(ctx).seek(offset, static_cast<seek_origin>(whence));
+    }
+
+    Sint64 adapter_size(SDL_RWops* ctx)
+    {
+        return adapter_of(ctx).size();
+    }
+
+    int adapter_close(SDL_RWops* ctx)
+    {
+        delete &adapter_of(ctx);
+        ::SDL_FreeRW(ctx);
+
+        return 0;
+    }
+
+    std::ios::seekdir direction(seek_origin origin)
+    {
+        switch (origin)
+        {
+        case seek_origin::begin:
+            return std::ios::beg;
+
+        case seek_origin::current:
+            return std::ios::cur;
+
+        case seek_origin::end:
+            return std::ios::end;
+        }
+
+        return std::ios::beg;
+    }
+
+    output_buffer& emptied(output_buffer& buf)
+    {
+        buf.clear();
+        return buf;
+    }
+
+    // Standard streams. Not owned.
+    class istream_source
+    {
+    public:
+        istream_source(std::istream& str)
+            : m_buf { *str.rdbuf() }
+        {
+        }
+
+        std::size_t read(std::span<std::byte> buf)
+        {
+            return static_cast<std::size_t>(m_buf.sgetn(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size())));
+        }
+
+        i64 seek(i64 offset, seek_origin origin)
+        {
+            return m_buf.pubseekoff(offset, direction(origin), std::ios::in);
+        }
+
+        i64 size()
+        {
+            const std::streamoff pos { m_buf.pubseekoff(0, std::ios::cur, std::ios::in) };
+            const std::streamoff end { m_buf.pubseekoff(0, std::ios::end, std::ios::in) };
+
+            m_buf.pubseekpos(pos, std::ios::in);
+
+            return pos < 0 ? -1 : end;
+        }
+
+    private:
+        std::streambuf& m_buf;
+    };
+
+    class ostream_sink
+    {
+    public:
+        ostream_sink(std::ostream& str)
+            : m_buf { *str.rdbuf() }
+        {
+        }
+
+        std::size_t write(std::span<const std::byte> buf)
+        {
+            return static_cast<std::size_t>(m_buf.sputn(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size())));
+        }
+
+        i64 seek(i64 offset, seek_origin origin)
+        {
+            return m_buf.pubseekoff(offset, direction(origin), std::ios::out);
+        }
+
+    private:
+        std::streambuf& m_buf;
+    };
+
+    // Free the data, then the RWops itself, like SDL's own memory RWops do.
+    template <void (*Free)(std::span<const std::byte>)>
+    int close_memory(SDL_RWops* ctx)
+    {
+        Free({ reinterpret_cast<const std::byte*>(ctx->hidden.mem.base), static_cast<std::size_t>(ctx->hidden.mem.stop - ctx->hidden.mem.base) });
+        ::SDL_FreeRW(ctx);
+
+        return 0;
+    }
+
+    void free_owned(std::span<const std::byte> data)
+    {
+        delete[] data.data();
+    }
+
+    SDL_RWops* map_or_open(const char* path)
+    {
+        detail::file_map map { path, detail::file_map::access::sequential };
+
+        // Let SDL handle (and report) everything that can't be mapped.
+        if (!map.valid())
+            return ::SDL_RWFromFile(path, "r");
+
+        SDL_RWops* const ctx { ::SDL_RWFromConstMem(map.data().data(), static_cast<int>(map.data().size())) };
+
+        if (ctx != nullptr)
+        {
+            ctx->close = close_memory<detail::file_map::free>;
+            map.release();
+        }
+
+        return ctx;
+    }
+}
+
 accessor::accessor(const char* path)
     : rwops { ::SDL_RWFromFile(path, "r") }
 
@@ -13,6 +311,31 @@ accessor::accessor(std::string_view path)
 {
 }
 
+accessor::accessor(std::istream& str, std::size_t read_ahead)
+    : accessor { istream_source { str }, read_ahead }
+{
+}
+
+accessor::accessor(const char* path, HAL_TAG_NAME(mapped))
+    : rwops { map_or_open(path) }
+{
+}
+
+accessor::accessor(std::string_view path, HAL_TAG_NAME(mapped))
+    : accessor { path.data(), tag::mapped }
+{
+}
+
+accessor::accessor(std::unique_ptr<std::byte[]> data, std::size_t size, pass_key<archive>)
+    : rwops { ::SDL_RWFromConstMem(data.get(), static_cast<int>(size)) }
+{
+    if (valid())
+    {
+        raii_object::get()->close = close_memory<free_owned>;
+        data.release();
+    }
+}
+
 SDL_RWops* accessor::get(pass_key<image::context>) const
 {
     return raii_object::get();
@@ -44,6 +367,16 @@ outputter::outputter(std::string_view path)
 {
 }
 
+outputter::outputter(std::ostream& str)
+    : outputter { ostream_sink { str } }
+{
+}
+
+outputter::outputter(output_buffer& buf)
+    : outputter { std::ref(emptied(buf)) }
+{
+}
+
 SDL_RWops* outputter::use(pass_key<view<const surface>>)
 {
     return raii_object::release();
@@ -52,4 +385,48 @@ SDL_RWops* outputter::use(pass_key<view<const surface>>)
 SDL_RWops* outputter::use(pass_key<image::context>)
 {
     return raii_object::release();
+}
+
+SDL_RWops* outputter::use(pass_key<archive>)
+{
+    return raii_object::release();
+}
+
+std::size_t detail::stream::read(std::span<std::byte>)
+{
+    return 0;
+}
+
+std::size_t detail::stream::write(std::span<const std::byte>)
+{
+    return 0;
+}
+
+i64 detail::stream::seek(i64, seek_origin)
+{
+    return -1;
+}
+
+i64 detail::stream::size()
+{
+    return -1;
+}
+
+SDL_RWops* detail::make_rwops(std::unique_ptr<stream> s, std::size_t read_ahead)
+{
+    SDL_RWops* const ctx { ::SDL_AllocRW() };
+
+    if (ctx == nullptr)
+        return nullptr;
+
+    ctx->size  = adapter_size;
+    ctx->seek  = adapter_seek;
+    ctx->read  = adapter_read;
+    ctx->write = adapter_write;
+    ctx->close = adapter_close;
+    ctx->type  = SDL_RWOPS_UNKNOWN;
+
+    ctx->hidden.unknown.data1 = new adapter { std::move(s), read_ahead };
+
+    return ctx;
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include <halcyon/profiler.hpp>
+
+#ifdef HAL_PROFILE_ENABLED
+
+    #include <atomic>
+    #include <memory>
+    #include <mutex>
+    #include <ostream>
+    #include <vector>
+
+using namespace hal;
+using namespace hal::profiler;
+
+namespace
+{
+    struct event
+    {
+        const char*       name;
+        clock::time_point begin, end;
+    };
+
+    // A single-producer, single-consumer ring of events. The owning thread pushes,
+    // write_trace() pops; the two only ever share the head and tail indices.
+    struct ring
+    {
+        static constexpr std::size_t capacity { 1 << 13 };
+
+        std::array<event, capacity> events;
+
+        std::atomic<u64> head { 0 }, tail { 0 };
+
+        u32 tid;
+
+        bool push(const event& evt)
+        {
+            const u64 h { head.load(std::memory_order_relaxed) };
+
+            if (h - tail.load(std::memory_order_acquire) == capacity)
+                return false;
+
+            events[h % capacity] = evt;
+            head.store(h + 1, std::memory_order_release);
+
+            return true;
+        }
+    };
+
+    struct registry
+    {
+        // Only locked when a thread records its first zone and when exporting.
+        std::mutex                         mutex;
+        std::vector<std::shared_ptr<ring>> rings;
+        std::vector<frame_stats>           frames;
+
+        std::array<std::atomic<u64>, counter_count> current {};
+        frame_stats                                 last {};
+
+        std::atomic<u64> dropped { 0 };
+    };
+
+    // Trace timestamps are relative to program startup.
+    const clock::time_point epoch { clock::now() };
+
+    registry& reg()
+    {
+        static registry r;
+        return r;
+    }
+
+    ring& local_ring()
+    {
+        // Shared ownership, so that events of finished threads can still be exported.
+        thread_local const std::shared_ptr<ring> r { []()
+            {
+                auto ret = std::make_shared<ring>();
+
+                registry&             rg { reg() };
+                const std::lock_guard lock { rg.mutex };
+
+                ret->tid = static_cast<u32>(rg.rings.size());
+                rg.rings.push_back(ret);
+
+                return ret;
+            }() };
+
+        return *r;
+    }
+
+    void write_string(std::ostream& str, const char* s)
+    {
+        str << '"';
+
+        for (; *s != '\0'; ++s)
+        {
+            if (*s == '"' || *s == '\\')
+                str << '\\';
+
+            str << *s;
+        }
+
+        str << '"';
+    }
+
+    f64 micros(clock::time_point tp)
+    {
+        return std::chrono::duration<f64, std::micro> { tp - epoch }.count();
+    }
+}
+
+zone::zone(const char* name)
+    : m_name { name }
+    , m_begin { clock::now() }
+{
+}
+
+zone::~zone()
+{
+    if (!local_ring().push({ m_name, m_begin, clock::now() }))
+        reg().dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void profiler::count(counter c, u64 amount)
+{
+    reg().current[static_cast<std::size_t>(c)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void profiler::frame()
+{
+    registry& rg { reg() };
+
+    frame_stats stats { clock::now() };
+
+    for (std::size_t i { 0 }; i < counter_count; ++i)
+        stats.counters[i] = rg.current[i].exchange(0, std::memory_order_relaxed);
+
+    const std::lock_guard lock { rg.mutex };
+
+    rg.last = stats;
+
+    // Same as zones - drop rather than grow without bounds when nobody's exporting.
+    if (rg.frames.size() < ring::capacity)
+        rg.frames.push_back(stats);
+}
+
+frame_stats profiler::last_frame()
+{
+    registry&             rg { reg() };
+    const std::lock_guard lock { rg.mutex };
+
+    return rg.last;
+}
+
+void profiler::write_trace(std::ostream& str)
+{
+    constexpr const char* counter_names[counter_count] { "draw_calls", "texture_uploads", "bytes_blitted", "glyphs_rasterized" };
+
+    registry&             rg { reg() };
+    const std::lock_guard lock { rg.mutex };
+
+    str << "{\"traceEvents\":[";
+
+    bool first { true };
+
+    const auto separate = [&]()
+    {
+        if (!first)
+            str << ',';
+
+        first = false;
+    };
+
+    for (const std::shared_ptr<ring>& r : rg.rings)
+    {
+        const u64 h { r->head.load(std::memory_order_acquire) };
+
+        for (u64 t { r->tail.load(std::memory_order_relaxed) }; t != h; ++t)
+        {
+            const event& evt { r->events[t % ring::capacity] };
+
+            separate();
+
+            str << "{\"name\":";
+            write_string(str, evt.name);
+            str << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << r->tid << ",\"ts\":" << micros(evt.begin) << ",\"dur\":" << micros(evt.end) - micros(evt.begin) << '}';
+        }
+
+        r->tail.store(h, std::memory_order_release);
+    }
+
+    for (const frame_stats& fs : rg.frames)
+    {
+        separate();
+
+        str << "{\"name\":\"frame\",\"ph\":\"C\",\"pid\":0,\"ts\":" << micros(fs.end) << ",\"args\":{";
+
+        for (std::size_t i { 0 }; i < counter_count; ++i)
+            str << (i == 0 ? "" : ",") << '"' << counter_names[i] << "\":" << fs.counters[i];
+
+        str << "}}";
+    }
+
+    rg.frames.clear();
+
+    str << "]}";
+}
+
+u64 profiler::dropped()
+{
+    return reg().dropped.load(std::memory_order_relaxed);
+}
+
+#endif
\ No newline at end of file
@@ -2,10 +2,17 @@
 
 #include <climits>
 #include <cstring>
+#include <vector>
+#include <utility>
 
 #include <SDL_image.h>
 
+#include <halcyon/internal/resample.hpp>
+
+#include <halcyon/profiler.hpp>
+
 #include <halcyon/utility/locks.hpp>
+#include <halcyon/utility/thread_pool.hpp>
 
 using namespace hal;
 
@@ -16,6 +23,62 @@ namespace
     {
         return ::SDL_MapRGBA(fmt, c.r, c.g, c.b, c.a);
     }
+
+    // Nearest-neighbour scaling that samples source pixel centers and copies pixels as-is,
+    // without blending. Rows are split into bands when given a thread pool; either way,
+    // the output is the same.
+    surface nearest(view<const surface> surf, pixel::point sz, thread_pool* pool)
+    {
+        // Work in the default format, which also makes every pixel a single u32.
+        // Converting turns color keys into alpha.
+        surface converted;
+
+        if (surf.pixel_format() != surface::default_pixel_format || ::SDL_HasColorKey(surf.get()))
+            converted = pool != nullptr ? surf.convert(surface::default_pixel_format, *pool) : surf.convert(surface::default_pixel_format);
+
+        SDL_Surface* const src { converted.valid() ? converted.get() : surf.get() };
+
+        // RLE-encoded pixels are decoded by locking.
+        const bool must_lock { SDL_MUSTLOCK(src) };
+
+        if (must_lock)
+            HAL_ASSERT_VITAL(::SDL_LockSurface(src) == 0, debug::last_error());
+
+        surface ret { sz };
+
+        SDL_Surface* const dst { ret.get() };
+
+        // Columns are the same for every row, so look them up once.
+        std::vector<pixel_t> columns(sz.x);
+
+        for (pixel_t x { 0 }; x < sz.x; ++x)
+            columns[x] = static_cast<pixel_t>((2 * static_cast<i64>(x) + 1) * src->w / (2 * static_cast<i64>(sz.x)));
+
+        const auto rows = [&](pixel_t begin, pixel_t end)
+        {
+            for (pixel_t y { begin }; y < end; ++y)
+            {
+                const pixel_t sy { static_cast<pixel_t>((2 * static_cast<i64>(y) + 1) * src->h / (2 * static_cast<i64>(sz.y))) };
+
+                const u32* const src_row { reinterpret_cast<const u32*>(static_cast<const std::byte*>(src->pixels) + sy * src->pitch) };
+                u32* const       dst_row { reinterpret_cast<u32*>(static_cast<std::byte*>(dst->pixels) + y * dst->pitch) };
+
+                for (pixel_t x { 0 }; x < sz.x; ++x)
+                    dst_row[x] = src_row[columns[x]];
+            }
+        };
+
+        if (pool != nullptr)
+            ret.for_each_band(*pool, rows);
+
+        else
+            rows(0, sz.y);
+
+        if (must_lock)
+            ::SDL_UnlockSurface(src);
+
+        return ret;
+    }
 }
 
 using cv = view<const surface>;
@@ -29,6 +92,8 @@ cv::view(SDL_Surface* ptr, pass_key<view<const window>>)
 
 void cv::save(outputter dst) const
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_SaveBMP_RW(get(), dst.use(pass_key<cv> {}), true) == 0, debug::last_error());
 }
 
@@ -39,6 +104,8 @@ blitter cv::blit(surface& dst) const
 
 surface cv::convert(pixel::format fmt) const
 {
+    HAL_PROFILE_FUNCTION();
+
     return { ::SDL_ConvertSurfaceFormat(get(), static_cast<Uint32>(fmt), 0), pass_key<cv> {} };
 }
 
@@ -84,18 +151,90 @@ color::value_t cv::alpha_mod() const
 
 surface cv::resize(pixel::point sz) const
 {
-    surface ret { sz };
-
-    blit(ret).to(tag::fill)();
+    HAL_PROFILE_FUNCTION();
 
-    return ret;
+    return nearest(*this, sz, nullptr);
 }
 
 surface cv::resize(scaler scl) const
 {
+    if (scl.filter() != filter::nearest)
+        return resize(scl(size()), scl.filter());
+
     return resize(scl(size()));
 }
 
+surface cv::convert(pixel::format fmt, thread_pool& pool) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    SDL_Surface* const src { get() };
+
+    // SDL_ConvertPixels handles neither palettes nor color keys.
+    if (SDL_ISPIXELFORMAT_INDEXED(src->format->format) || SDL_ISPIXELFORMAT_INDEXED(static_cast<Uint32>(fmt)) || ::SDL_HasColorKey(src) || SDL_MUSTLOCK(src))
+        return convert(fmt);
+
+    surface ret { size(), fmt };
+
+    SDL_Surface* const dst { ret.get() };
+
+    for_each_band(pool, [&](pixel_t begin, pixel_t end)
+        {
+            HAL_ASSERT_VITAL(::SDL_ConvertPixels(src->w, end - begin,
+                                 src->format->format, static_cast<const std::byte*>(src->pixels) + begin * src->pitch, src->pitch,
+                                 dst->format->format, static_cast<std::byte*>(dst->pixels) + begin * dst->pitch, dst->pitch)
+                    == 0,
+                debug::last_error());
+        });
+
+    return ret;
+}
+
+surface cv::resize(pixel::point sz, thread_pool& pool) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    return nearest(*this, sz, &pool);
+}
+
+surface cv::resize(scaler scl, thread_pool& pool) const
+{
+    if (scl.filter() != filter::nearest)
+        return resize(scl(size()), scl.filter(), pool);
+
+    return resize(scl(size()), pool);
+}
+
+surface cv::resize(pixel::point sz, enum filter f) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (f == filter::nearest)
+        return resize(sz);
+
+    return detail::resample(*this, sz, f, nullptr);
+}
+
+surface cv::resize(pixel::point sz, enum filter f, thread_pool& pool) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (f == filter::nearest)
+        return resize(sz, pool);
+
+    return detail::resample(*this, sz, f, &pool);
+}
+
+void cv::for_each_band(thread_pool& pool, const std::function<void(pixel_t, pixel_t)>& func) const
+{
+    // A few bands per thread, so that uneven bands still balance out.
+    const std::size_t height { static_cast<std::size_t>(get()->h) };
+    const std::size_t bands { pool.concurrency() * 4 };
+
+    pool.parallel_for(height, (height + bands - 1) / bands, [&](std::size_t begin, std::size_t end)
+        { func(static_cast<pixel_t>(begin), static_cast<pixel_t>(end)); });
+}
+
 const_pixel_reference cv::operator[](pixel::point pos) const
 {
     HAL_ASSERT(pos.x < get()->w, "Out-of-range width");
@@ -110,19 +249,39 @@ using v = view<surface>;
 
 void v::fill(color clr)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_FillRect(get(), nullptr, mapped(get()->format, clr)) == 0, debug::last_error());
 }
 
 void v::fill(pixel::rect area, color clr)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_FillRect(get(), area.addr(), mapped(get()->format, clr)) == 0, debug::last_error());
 }
 
 void v::fill(std::span<const pixel::rect> areas, color clr)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_FillRects(get(), reinterpret_cast<const SDL_Rect*>(areas.data()), static_cast<int>(areas.size()), mapped(get()->format, clr)) == 0, debug::last_error());
 }
 
+void v::fill(color clr, thread_pool& pool)
+{
+    HAL_PROFILE_FUNCTION();
+
+    const Uint32 value { mapped(get()->format, clr) };
+
+    for_each_band(pool, [&](pixel_t begin, pixel_t end)
+        {
+            const pixel::rect band { 0, begin, get()->w, end - begin };
+
+            HAL_ASSERT_VITAL(::SDL_FillRect(get(), band.addr(), value) == 0, debug::last_error());
+        });
+}
+
 void v::blend(blend_mode bm)
 {
     HAL_ASSERT_VITAL(::SDL_SetSurfaceBlendMode(get(), SDL_BlendMode(bm)) == 0, debug::last_error());
@@ -138,6 +297,41 @@ void v::alpha_mod(color::value_t val)
     HAL_ASSERT_VITAL(::SDL_SetSurfaceAlphaMod(get(), val) == 0, debug::last_error());
 }
 
+void v::invert()
+{
+    HAL_PROFILE_FUNCTION();
+
+    detail::kernels::invert(detail::kernels::image_of(get()));
+}
+
+void v::multiply(color c)
+{
+    HAL_PROFILE_FUNCTION();
+
+    detail::kernels::multiply(detail::kernels::image_of(get()), c);
+}
+
+void v::premultiply()
+{
+    HAL_PROFILE_FUNCTION();
+
+    detail::kernels::premultiply(detail::kernels::image_of(get()));
+}
+
+void v::grayscale()
+{
+    HAL_PROFILE_FUNCTION();
+
+    detail::kernels::grayscale(detail::kernels::image_of(get()));
+}
+
+void v::swizzle(channel r, channel g, channel b, channel a)
+{
+    HAL_PROFILE_FUNCTION();
+
+    detail::kernels::swizzle(detail::kernels::image_of(get()), { std::to_underlying(r), std::to_underlying(g), std::to_underlying(b), std::to_underlying(a) });
+}
+
 pixel_reference v::operator[](pixel::point pos)
 {
     return { static_cast<std::byte*>(get()->pixels), get()->pitch, get()->format, pos, pass_key<v> {} };
@@ -245,6 +439,8 @@ void pixel_reference::set_mapped(Uint32 mapped)
 
 void blitter::operator()()
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_BlitScaled(
                          m_this.get(),
                          m_src.pos.x == unset_pos<src_t>() ? nullptr : reinterpret_cast<const SDL_Rect*>(m_src.addr()),
@@ -252,10 +448,15 @@ void blitter::operator()()
                          m_dst.pos.x == unset_pos<dst_t>() ? nullptr : reinterpret_cast<SDL_Rect*>(m_dst.addr()))
             == 0,
         debug::last_error());
+
+    // SDL writes the clipped destination area back.
+    HAL_PROFILE_COUNT(bytes_blitted, static_cast<u64>(m_dst.pos.x == unset_pos<dst_t>() ? m_pass.size().x * m_pass.size().y : m_dst.size.x * m_dst.size.y) * m_pass.get()->format->BytesPerPixel);
 }
 
 void blitter::operator()(HAL_TAG_NAME(keep_dst)) const
 {
+    HAL_PROFILE_FUNCTION();
+
     pixel::rect copy { m_dst };
 
     HAL_ASSERT_VITAL(::SDL_BlitScaled(
@@ -265,4 +466,6 @@ void blitter::operator()(HAL_TAG_NAME(keep_dst)) const
                          m_dst.pos.x == unset_pos<dst_t>() ? nullptr : copy.addr())
             == 0,
         debug::last_error());
+
+    HAL_PROFILE_COUNT(bytes_blitted, static_cast<u64>(m_dst.pos.x == unset_pos<dst_t>() ? m_pass.size().x * m_pass.size().y : copy.size.x * copy.size.y) * m_pass.get()->format->BytesPerPixel);
 }
\ No newline at end of file
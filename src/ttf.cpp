@@ -1,5 +1,9 @@
 #include <halcyon/ttf.hpp>
 
+#include <algorithm>
+
+#include <halcyon/profiler.hpp>
+
 using namespace hal;
 
 using cv = view<const font>;
@@ -16,6 +20,8 @@ builder::font_glyph cv::render(char32_t glyph) const
 
 pixel::point cv::size_text(const std::string_view& text) const
 {
+    HAL_PROFILE_FUNCTION();
+
     point<int> size;
 
     ::TTF_SizeUTF8(get(), text.data(), &size.x, &size.y);
@@ -74,6 +80,8 @@ ttf::context::~context()
 
 font ttf::context::load(accessor data, font::pt_t size) &
 {
+    HAL_PROFILE_FUNCTION();
+
     return { std::move(data), size, pass_key<context> {} };
 }
 
@@ -100,6 +108,10 @@ bft& bft::wrap(pixel_t wl)
 
 surface bft::operator()(font::render_type rt)
 {
+    HAL_PROFILE_FUNCTION();
+    HAL_PROFILE_COUNT(glyphs_rasterized, std::ranges::count_if(std::string_view { m_text }, [](char c)
+        { return (static_cast<u8>(c) & 0xC0) != 0x80; }));
+
     using enum font::render_type;
 
     if (m_wrapLength == invalid()) // Not wrapping.
@@ -151,6 +163,9 @@ bfg::font_glyph(cv fnt, char32_t glyph, pass_key<cv> pk)
 
 surface bfg::operator()(font::render_type rt)
 {
+    HAL_PROFILE_FUNCTION();
+    HAL_PROFILE_COUNT(glyphs_rasterized, 1);
+
     using enum font::render_type;
 
     switch (rt)
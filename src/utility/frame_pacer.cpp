@@ -0,0 +1,205 @@
+#include <halcyon/utility/frame_pacer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <halcyon/debug.hpp>
+
+using namespace hal;
+
+frame_histogram::frame_histogram(duration width, std::size_t buckets)
+    : m_buckets(buckets, 0)
+    , m_width { width }
+{
+    HAL_ASSERT(width > duration::zero() && buckets > 0, "Invalid histogram dimensions");
+}
+
+void frame_histogram::add(duration frame)
+{
+    frame = std::max(frame, duration::zero());
+
+    ++m_buckets[std::min(static_cast<std::size_t>(frame / m_width), m_buckets.size() - 1)];
+
+    m_min = std::min(m_min, frame);
+    m_max = std::max(m_max, frame);
+    m_total += frame;
+    ++m_count;
+}
+
+void frame_histogram::clear()
+{
+    std::ranges::fill(m_buckets, 0);
+
+    m_min   = duration::max();
+    m_max   = duration::zero();
+    m_total = duration::zero();
+    m_count = 0;
+}
+
+frame_histogram::duration frame_histogram::percentile(f64 frac) const
+{
+    if (m_count == 0)
+        return duration::zero();
+
+    const std::size_t target { static_cast<std::size_t>(std::ceil(std::clamp(frac, 0.0, 1.0) * m_count)) };
+
+    std::size_t sum { 0 };
+
+    for (std::size_t i { 0 }; i < m_buckets.size() - 1; ++i)
+    {
+        sum += m_buckets[i];
+
+        if (sum >= target)
+            return std::min(m_width * static_cast<duration::rep>(i + 1), m_max);
+    }
+
+    return m_max;
+}
+
+frame_histogram::duration frame_histogram::min() const
+{
+    return m_count == 0 ? duration::zero() : m_min;
+}
+
+frame_histogram::duration frame_histogram::max() const
+{
+    return m_max;
+}
+
+frame_histogram::duration frame_histogram::mean() const
+{
+    return m_count == 0 ? duration::zero() : m_total / static_cast<duration::rep>(m_count);
+}
+
+std::span<const u32> frame_histogram::buckets() const
+{
+    return m_buckets;
+}
+
+frame_histogram::duration frame_histogram::bucket_width() const
+{
+    return m_width;
+}
+
+std::size_t frame_histogram::count() const
+{
+    return m_count;
+}
+
+frame_pacer::frame_pacer(f64 fps)
+    : m_deadline { m_frame.time_point() }
+{
+    target_fps(fps);
+}
+
+f64 frame_pacer::tick()
+{
+    wait();
+
+    const clock::time_point now { clock::now() };
+    const duration          frame { std::chrono::duration_cast<duration>(now - m_frame.time_point()) };
+
+    m_frame.reset();
+    m_histogram.add(frame);
+
+    const f64 secs { std::chrono::duration<f64> { frame }.count() };
+
+    m_accumulator = std::min(m_accumulator + secs, m_step * m_max_steps);
+
+    return secs;
+}
+
+bool frame_pacer::step()
+{
+    if (m_accumulator < m_step)
+        return false;
+
+    m_accumulator -= m_step;
+    return true;
+}
+
+f64 frame_pacer::alpha() const
+{
+    return std::clamp(m_accumulator / m_step, 0.0, 1.0);
+}
+
+f64 frame_pacer::target_fps() const
+{
+    return m_period == duration::zero() ? 0.0 : 1.0 / std::chrono::duration<f64> { m_period }.count();
+}
+
+void frame_pacer::target_fps(f64 fps)
+{
+    HAL_ASSERT(fps >= 0.0, "Negative target frame rate");
+
+    m_period = fps == 0.0 ? duration::zero() : std::chrono::duration_cast<duration>(std::chrono::duration<f64> { 1.0 / fps });
+}
+
+f64 frame_pacer::step_size() const
+{
+    return m_step;
+}
+
+void frame_pacer::step_size(f64 secs)
+{
+    HAL_ASSERT(secs > 0.0, "Non-positive fixed step");
+
+    m_step = secs;
+}
+
+u32 frame_pacer::max_steps() const
+{
+    return m_max_steps;
+}
+
+void frame_pacer::max_steps(u32 steps)
+{
+    HAL_ASSERT(steps > 0, "A frame must allow at least one fixed step");
+
+    m_max_steps = steps;
+}
+
+frame_pacer::duration frame_pacer::spin_threshold() const
+{
+    return m_spin;
+}
+
+void frame_pacer::spin_threshold(duration dur)
+{
+    m_spin = std::max(dur, duration::zero());
+}
+
+const frame_histogram& frame_pacer::histogram() const
+{
+    return m_histogram;
+}
+
+frame_histogram& frame_pacer::histogram()
+{
+    return m_histogram;
+}
+
+void frame_pacer::wait()
+{
+    if (m_period == duration::zero())
+        return;
+
+    // Deadlines advance by whole periods so that rounding doesn't accumulate into drift.
+    m_deadline += m_period;
+
+    const clock::time_point now { clock::now() };
+
+    // Too far behind - don't try to catch up by rushing through frames.
+    if (m_deadline + m_period < now)
+    {
+        m_deadline = now;
+        return;
+    }
+
+    if (m_deadline - m_spin > now)
+        std::this_thread::sleep_until(m_deadline - m_spin);
+
+    while (clock::now() < m_deadline)
+        ;
+}
\ No newline at end of file
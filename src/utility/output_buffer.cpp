@@ -0,0 +1,138 @@
+#include <halcyon/utility/output_buffer.hpp>
+
+#include <algorithm>
+
+using namespace hal;
+
+output_buffer::output_buffer(std::size_t capacity)
+{
+    reserve(capacity);
+}
+
+std::size_t output_buffer::write(std::span<const std::byte> src)
+{
+    const std::size_t end { m_pos + src.size() };
+
+    // Grows geometrically, and fills any gap left by seeking past the end with zeroes.
+    if (end > m_data.size())
+        m_data.resize(end);
+
+    std::ranges::copy(src, m_data.begin() + static_cast<std::ptrdiff_t>(m_pos));
+    m_pos = end;
+
+    return src.size();
+}
+
+i64 output_buffer::seek(i64 offset, seek_origin origin)
+{
+    i64 target;
+
+    switch (origin)
+    {
+    case seek_origin::begin:
+        target = offset;
+        break;
+
+    case seek_origin::current:
+        target = static_cast<i64>(m_pos) + offset;
+        break;
+
+    case seek_origin::end:
+        target = static_cast<i64>(m_data.size()) + offset;
+        break;
+
+    default:
+        return -1;
+    }
+
+    if (target < 0)
+        return -1;
+
+    m_pos = static_cast<std::size_t>(target);
+
+    return target;
+}
+
+std::span<const std::byte> output_buffer::data() const
+{
+    return m_data;
+}
+
+std::size_t output_buffer::size() const
+{
+    return m_data.size();
+}
+
+std::size_t output_buffer::capacity() const
+{
+    return m_data.capacity();
+}
+
+void output_buffer::reserve(std::size_t capacity)
+{
+    m_data.reserve(capacity);
+}
+
+void output_buffer::clear()
+{
+    m_data.clear();
+    m_pos = 0;
+}
+
+output_buffer::pool::lease::lease(pool& p, std::unique_ptr<output_buffer> buf, pass_key<pool>)
+    : m_pool { &p }
+    , m_buffer { std::move(buf) }
+{
+}
+
+output_buffer::pool::lease::~lease()
+{
+    if (m_buffer != nullptr)
+        m_pool->put_back(std::move(m_buffer));
+}
+
+output_buffer& output_buffer::pool::lease::operator*() const
+{
+    return *m_buffer;
+}
+
+output_buffer* output_buffer::pool::lease::operator->() const
+{
+    return m_buffer.get();
+}
+
+output_buffer::pool::lease output_buffer::pool::acquire()
+{
+    std::unique_ptr<output_buffer> buf;
+
+    {
+        const std::lock_guard lock { m_mutex };
+
+        if (!m_free.empty())
+        {
+            buf = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+
+    if (buf == nullptr)
+        buf = std::make_unique<output_buffer>();
+
+    return { *this, std::move(buf), pass_key<pool> {} };
+}
+
+std::size_t output_buffer::pool::available() const
+{
+    const std::lock_guard lock { m_mutex };
+
+    return m_free.size();
+}
+
+void output_buffer::pool::put_back(std::unique_ptr<output_buffer> buf)
+{
+    buf->clear();
+
+    const std::lock_guard lock { m_mutex };
+
+    m_free.push_back(std::move(buf));
+}
\ No newline at end of file
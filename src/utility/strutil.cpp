@@ -10,4 +10,88 @@ bool hal::streq(const char* lhs, const char* rhs)
 bool hal::streq(const wchar_t* lhs, const wchar_t* rhs)
 {
     return std::wcscmp(lhs, rhs) == 0;
+}
+
+char32_t hal::pop_codepoint(std::string_view& str)
+{
+    constexpr char32_t replacement { 0xFFFD };
+
+    const auto byte = [&](std::size_t i)
+    { return static_cast<unsigned char>(str[i]); };
+
+    const unsigned char lead { byte(0) };
+
+    std::size_t length;
+    char32_t    cp;
+
+    // Allowed range of the second byte. Narrowed for some leads, so that overlong forms,
+    // UTF-16 surrogates and code points past U+10FFFF are rejected.
+    unsigned char lo { 0x80 }, hi { 0xBF };
+
+    if (lead < 0x80)
+    {
+        str.remove_prefix(1);
+        return lead;
+    }
+
+    // C0 and C1 could only start overlong forms.
+    else if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+        cp     = lead & 0x1F;
+    }
+
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        cp     = lead & 0x0F;
+
+        if (lead == 0xE0)
+            lo = 0xA0;
+
+        else if (lead == 0xED)
+            hi = 0x9F;
+    }
+
+    // Anything past F4 would be beyond U+10FFFF.
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        cp     = lead & 0x07;
+
+        if (lead == 0xF0)
+            lo = 0x90;
+
+        else if (lead == 0xF4)
+            hi = 0x8F;
+    }
+
+    else
+    {
+        str.remove_prefix(1);
+        return replacement;
+    }
+
+    if (str.size() < length)
+    {
+        str.remove_prefix(1);
+        return replacement;
+    }
+
+    for (std::size_t i { 1 }; i < length; ++i)
+    {
+        const unsigned char b { byte(i) };
+
+        if (b < (i == 1 ? lo : 0x80) || b > (i == 1 ? hi : 0xBF))
+        {
+            str.remove_prefix(1);
+            return replacement;
+        }
+
+        cp = (cp << 6) | (b & 0x3F);
+    }
+
+    str.remove_prefix(length);
+
+    return cp;
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <halcyon/utility/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <latch>
+
+using namespace hal;
+
+std::size_t thread_pool::default_workers()
+{
+    const std::size_t hw { std::thread::hardware_concurrency() };
+
+    return hw > 1 ? hw - 1 : 0;
+}
+
+thread_pool::thread_pool(std::size_t workers)
+{
+    m_threads.reserve(workers);
+
+    for (std::size_t i { 0 }; i < workers; ++i)
+        m_threads.emplace_back(&thread_pool::work, this);
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        const std::lock_guard lock { m_mutex };
+        m_stop = true;
+    }
+
+    m_cv.notify_all();
+
+    // Join before any other member goes away.
+    m_threads.clear();
+}
+
+void thread_pool::submit(task t)
+{
+    if (m_threads.empty())
+    {
+        t();
+        return;
+    }
+
+    {
+        const std::lock_guard lock { m_mutex };
+        m_tasks.push_back(std::move(t));
+    }
+
+    m_cv.notify_one();
+}
+
+void thread_pool::parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& func)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max<std::size_t>(grain, 1);
+
+    const std::size_t chunks { (count + grain - 1) / grain };
+    const std::size_t helpers { std::min(m_threads.size(), chunks - 1) };
+
+    // Chunks are handed out dynamically, so uneven chunk costs still balance out.
+    std::atomic<std::size_t> next { 0 };
+    std::latch               done { static_cast<std::ptrdiff_t>(helpers) };
+
+    const auto run = [&]()
+    {
+        for (std::size_t begin; (begin = next.fetch_add(grain, std::memory_order_relaxed)) < count;)
+            func(begin, std::min(begin + grain, count));
+    };
+
+    for (std::size_t i { 0 }; i < helpers; ++i)
+    {
+        submit([&]()
+            {
+                run();
+                done.count_down();
+            });
+    }
+
+    run();
+    done.wait();
+}
+
+std::size_t thread_pool::concurrency() const
+{
+    return m_threads.size() + 1;
+}
+
+void thread_pool::work()
+{
+    while (true)
+    {
+        task t;
+
+        {
+            std::unique_lock lock { m_mutex };
+            m_cv.wait(lock, [this]()
+                { return m_stop || !m_tasks.empty(); });
+
+            // Only exit once everything queued is done.
+            if (m_tasks.empty())
+                return;
+
+            t = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        t();
+    }
+}
\ No newline at end of file
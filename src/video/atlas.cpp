@@ -0,0 +1,155 @@
+#include <halcyon/video/atlas.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <halcyon/debug.hpp>
+
+using namespace hal;
+
+namespace
+{
+    // Copy a surface's pixels into a page, converting them to the page's format first.
+    // Plain copying (as opposed to blitting) keeps alpha exactly as it is.
+    void copy_pixels(view<const surface> src, view<surface> dst, pixel::point pos)
+    {
+        surface converted;
+
+        if (src.pixel_format() != dst.pixel_format())
+        {
+            converted = src.convert(dst.pixel_format());
+            src       = converted;
+        }
+
+        SDL_Surface* const s { src.get() };
+        SDL_Surface* const d { dst.get() };
+
+        const bool must_lock { SDL_MUSTLOCK(s) };
+
+        if (must_lock)
+            HAL_ASSERT_VITAL(::SDL_LockSurface(s) == 0, debug::last_error());
+
+        const std::size_t row_size { static_cast<std::size_t>(s->w) * s->format->BytesPerPixel };
+
+        const std::byte* src_row { static_cast<const std::byte*>(s->pixels) };
+        std::byte*       dst_row { static_cast<std::byte*>(d->pixels) + pos.y * d->pitch + pos.x * d->format->BytesPerPixel };
+
+        for (int y { 0 }; y < s->h; ++y, src_row += s->pitch, dst_row += d->pitch)
+            std::memcpy(dst_row, src_row, row_size);
+
+        if (must_lock)
+            ::SDL_UnlockSurface(s);
+    }
+}
+
+// Atlas.
+
+atlas::atlas(std::vector<static_texture>&& pages, std::vector<entry>&& entries, pass_key<atlas_builder>)
+    : m_pages { std::move(pages) }
+    , m_entries { std::move(entries) }
+{
+}
+
+const atlas::entry& atlas::operator[](id_t id) const
+{
+    HAL_ASSERT(id < m_entries.size(), "Atlas ID out of range");
+
+    return m_entries[id];
+}
+
+view<const texture> atlas::page(u32 idx) const
+{
+    HAL_ASSERT(idx < m_pages.size(), "Atlas page out of range");
+
+    return m_pages[idx];
+}
+
+u32 atlas::pages() const
+{
+    return static_cast<u32>(m_pages.size());
+}
+
+std::size_t atlas::size() const
+{
+    return m_entries.size();
+}
+
+// Atlas builder.
+
+atlas_builder::atlas_builder(pixel::point page_size, pixel_t padding)
+    : m_pageSize { page_size }
+    , m_padding { padding }
+{
+    HAL_ASSERT(page_size.x > 0 && page_size.y > 0, "Invalid atlas page size");
+    HAL_ASSERT(padding >= 0, "Negative atlas padding");
+}
+
+atlas::id_t atlas_builder::add(view<const surface> surf)
+{
+    HAL_ASSERT(surf.valid(), "Adding null surface to atlas");
+
+    m_sources.push_back(surf);
+
+    return static_cast<atlas::id_t>(m_sources.size() - 1);
+}
+
+atlas atlas_builder::operator()(view<renderer> rnd) const
+{
+    // Tallest first - the skyline packer wastes far less space that way.
+    std::vector<atlas::id_t> order(m_sources.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(order.begin(), order.end(), [this](atlas::id_t lhs, atlas::id_t rhs)
+        {
+            const pixel::point ls { m_sources[lhs].size() }, rs { m_sources[rhs].size() };
+            return ls.y != rs.y ? ls.y > rs.y : ls.x > rs.x;
+        });
+
+    std::vector<detail::skyline> packers;
+    std::vector<surface>         pages;
+    std::vector<atlas::entry>    entries(m_sources.size());
+
+    for (const atlas::id_t id : order)
+    {
+        const pixel::point size { m_sources[id].size() };
+        const pixel::point padded { size.x + m_padding, size.y + m_padding };
+
+        // The packer can't place an empty rectangle, not even on a fresh page.
+        HAL_ASSERT_VITAL(size.x > 0 && size.y > 0, "Empty surface in atlas");
+        HAL_ASSERT_VITAL(padded.x <= m_pageSize.x && padded.y <= m_pageSize.y, "Surface too large for atlas page");
+
+        u32                         page { 0 };
+        std::optional<pixel::point> pos;
+
+        for (; page < packers.size() && !pos; ++page)
+            pos = packers[page].insert(padded);
+
+        if (pos)
+            --page;
+
+        else
+        {
+            packers.emplace_back(m_pageSize);
+            pages.emplace_back(m_pageSize);
+
+            pos = packers.back().insert(padded);
+        }
+
+        entries[id] = { page, { *pos, size } };
+        copy_pixels(m_sources[id], pages[page], *pos);
+    }
+
+    std::vector<static_texture> textures;
+    textures.reserve(pages.size());
+
+    for (const surface& page : pages)
+        textures.push_back(rnd.make_texture(page));
+
+    return { std::move(textures), std::move(entries), pass_key<atlas_builder> {} };
+}
+
+std::size_t atlas_builder::size() const
+{
+    return m_sources.size();
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include <halcyon/video/command_buffer.hpp>
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <halcyon/profiler.hpp>
+
+#include <halcyon/video/texture.hpp>
+
+using namespace hal;
+
+// Recorded copyer.
+
+recorded_copyer::recorded_copyer(command_buffer& buf, view<const texture> tex, pass_key<command_buffer>)
+    : drawer { view<renderer> {}, tex }
+    , m_buffer { buf }
+{
+}
+
+recorded_copyer& recorded_copyer::rotate(f64 angle)
+{
+    m_angle = angle;
+    return *this;
+}
+
+recorded_copyer& recorded_copyer::flip(enum flip f)
+{
+    m_flip = f;
+    return *this;
+}
+
+void recorded_copyer::operator()()
+{
+    m_buffer.copy(m_this, m_src, m_dst, m_angle, m_flip);
+}
+
+// Command buffer.
+
+namespace
+{
+    constexpr pixel_t unset_src { std::numeric_limits<pixel_t>::max() };
+    constexpr coord_t unset_dst { std::numeric_limits<coord_t>::max() };
+
+    struct line_args
+    {
+        coord::point from, to;
+    };
+
+    struct copy_args
+    {
+        SDL_Texture* tex;
+        pixel::rect  src;
+        coord::rect  dst;
+        f64          angle;
+        flip         f;
+    };
+
+    // Commands are stored unaligned, so they're always copied out.
+    template <typename T>
+    T read(const std::byte*& pos)
+    {
+        T ret;
+
+        std::memcpy(&ret, pos, sizeof(T));
+        pos += sizeof(T);
+
+        return ret;
+    }
+}
+
+template <typename T>
+void command_buffer::push(op o, const T& args)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Command arguments must be trivially copyable");
+
+    const std::size_t at { m_data.size() };
+
+    m_data.resize(at + sizeof(op) + sizeof(T));
+
+    std::memcpy(m_data.data() + at, &o, sizeof(op));
+    std::memcpy(m_data.data() + at + sizeof(op), &args, sizeof(T));
+
+    ++m_count;
+}
+
+void command_buffer::push(op o)
+{
+    const std::size_t at { m_data.size() };
+
+    m_data.resize(at + sizeof(op));
+
+    std::memcpy(m_data.data() + at, &o, sizeof(op));
+
+    ++m_count;
+}
+
+void command_buffer::clear()
+{
+    push(op::clear);
+}
+
+void command_buffer::draw(coord::point pt)
+{
+    push(op::point, pt);
+}
+
+void command_buffer::draw(coord::point from, coord::point to)
+{
+    push(op::line, line_args { from, to });
+}
+
+void command_buffer::draw(const coord::rect& area)
+{
+    push(op::outline, area);
+}
+
+void command_buffer::fill(const coord::rect& area)
+{
+    push(op::fill_rect, area);
+}
+
+void command_buffer::fill()
+{
+    push(op::fill);
+}
+
+void command_buffer::color(hal::color clr)
+{
+    push(op::color, clr);
+}
+
+void command_buffer::blend(blend_mode bm)
+{
+    push(op::blend, bm);
+}
+
+void command_buffer::target(target_texture& tx)
+{
+    // The texture itself, not its wrapper, which may move before the replay.
+    push(op::target, tx.get());
+}
+
+void command_buffer::reset_target()
+{
+    push(op::reset_target);
+}
+
+recorded_copyer command_buffer::render(view<const texture> tex)
+{
+    return { *this, tex, pass_key<command_buffer> {} };
+}
+
+void command_buffer::copy(view<const texture> tex, const pixel::rect& src, const coord::rect& dst, f64 angle, enum flip f)
+{
+    push(op::copy, copy_args { const_cast<SDL_Texture*>(tex.get()), src, dst, angle, f });
+}
+
+void command_buffer::replay(view<renderer> rnd) const
+{
+    HAL_PROFILE_FUNCTION();
+
+    const std::byte*       pos { m_data.data() };
+    const std::byte* const end { pos + m_data.size() };
+
+    while (pos != end)
+    {
+        switch (read<op>(pos))
+        {
+        case op::clear:
+            rnd.clear();
+            break;
+
+        case op::point:
+            rnd.draw(read<coord::point>(pos));
+            break;
+
+        case op::line:
+        {
+            const line_args args { read<line_args>(pos) };
+            rnd.draw(args.from, args.to);
+            break;
+        }
+
+        case op::outline:
+            rnd.draw(read<coord::rect>(pos));
+            break;
+
+        case op::fill_rect:
+            rnd.fill(read<coord::rect>(pos));
+            break;
+
+        case op::fill:
+            rnd.fill();
+            break;
+
+        case op::color:
+            rnd.color(read<hal::color>(pos));
+            break;
+
+        case op::blend:
+            rnd.blend(read<blend_mode>(pos));
+            break;
+
+        case op::target:
+            rnd.target(view<texture> { read<SDL_Texture*>(pos), pass_key<command_buffer> {} });
+            break;
+
+        case op::reset_target:
+            rnd.reset_target();
+            break;
+
+        case op::copy:
+        {
+            const copy_args args { read<copy_args>(pos) };
+
+            HAL_ASSERT_VITAL(::SDL_RenderCopyExF(rnd.get(), args.tex,
+                                 args.src.pos.x == unset_src ? nullptr : args.src.addr(),
+                                 args.dst.pos.x == unset_dst ? nullptr : args.dst.addr(),
+                                 args.angle, nullptr, static_cast<SDL_RendererFlip>(args.f))
+                    == 0,
+                debug::last_error());
+            HAL_PROFILE_COUNT(draw_calls, 1);
+            break;
+        }
+        }
+    }
+}
+
+void command_buffer::reset()
+{
+    m_data.clear();
+    m_count = 0;
+}
+
+void command_buffer::reserve(std::size_t bytes)
+{
+    m_data.reserve(bytes);
+}
+
+std::size_t command_buffer::size() const
+{
+    return m_count;
+}
+
+bool command_buffer::empty() const
+{
+    return m_count == 0;
+}
\ No newline at end of file
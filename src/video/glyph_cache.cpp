@@ -0,0 +1,246 @@
+#include <halcyon/video/glyph_cache.hpp>
+
+#include <halcyon/profiler.hpp>
+
+#include <halcyon/utility/strutil.hpp>
+
+using namespace hal;
+
+namespace
+{
+    u32 pack(color c)
+    {
+        return (static_cast<u32>(c.r) << 24) | (static_cast<u32>(c.g) << 16) | (static_cast<u32>(c.b) << 8) | c.a;
+    }
+}
+
+// Cached text.
+
+cached_text::cached_text(glyph_cache& cache, view<const font> fnt, std::string_view text, pass_key<glyph_cache>)
+    : m_cache { cache }
+    , m_font { fnt }
+    , m_text { text }
+{
+}
+
+cached_text& cached_text::fg(color c)
+{
+    m_fg = c;
+    return *this;
+}
+
+cached_text& cached_text::bg(color c)
+{
+    m_bg = c;
+    return *this;
+}
+
+cached_text& cached_text::type(font::render_type rt)
+{
+    m_type = rt;
+    return *this;
+}
+
+cached_text& cached_text::to(coord::point pos)
+{
+    m_pos = pos;
+    return *this;
+}
+
+void cached_text::operator()()
+{
+    m_cache.draw(m_font, m_text, m_pos, m_type, m_fg, m_bg);
+}
+
+// Glyph cache.
+
+glyph_cache::glyph_cache(view<renderer> rnd, pixel::point page_size)
+    : m_rnd { rnd }
+    , m_pageSize { page_size }
+{
+    HAL_ASSERT(page_size.x > 0 && page_size.y > 0, "Invalid glyph cache page size");
+}
+
+cached_text glyph_cache::draw(view<const font> fnt, std::string_view text)
+{
+    return { *this, fnt, text, pass_key<glyph_cache> {} };
+}
+
+void glyph_cache::draw(view<const font> fnt, std::string_view text, coord::point pos, font::render_type rt, color fg, color bg)
+{
+    HAL_PROFILE_FUNCTION();
+
+    const coord_t skip { static_cast<coord_t>(fnt.skip()) };
+
+    coord::point pen { pos };
+    char32_t     prev { 0 };
+
+    while (!text.empty())
+    {
+        const char32_t ch { pop_codepoint(text) };
+
+        if (ch == U'\n')
+        {
+            pen  = { pos.x, pen.y + skip };
+            prev = 0;
+
+            continue;
+        }
+
+        const glyph& g { get(fnt, ch, rt, fg, bg) };
+
+        if (prev != 0)
+            pen.x += static_cast<coord_t>(::TTF_GetFontKerningSizeGlyphs32(fnt.get(), prev, ch));
+
+        if (g.area.size.x > 0)
+            m_batches[g.page].push(g.area, { pen, static_cast<coord::point>(g.area.size) });
+
+        pen.x += static_cast<coord_t>(g.advance);
+        prev = ch;
+    }
+
+    for (sprite_batch& batch : m_batches)
+    {
+        if (batch.size() > 0)
+            batch.flush();
+    }
+}
+
+const glyph_cache::glyph& glyph_cache::get(view<const font> fnt, char32_t ch, font::render_type rt, color fg, color bg)
+{
+    using enum font::render_type;
+
+    // Background color only matters for some render types; don't let it split the cache otherwise.
+    if (rt == solid || rt == blended)
+        bg = palette::transparent;
+
+    const key k { fnt.get(), ch, rt, fg, bg };
+
+    if (const auto iter = m_glyphs.find(k); iter != m_glyphs.end())
+        return iter->second;
+
+    HAL_ASSERT(m_rnd.valid(), "Using a default-constructed glyph cache");
+
+    int advance { 0 };
+    HAL_ASSERT_VITAL(::TTF_GlyphMetrics32(fnt.get(), ch, nullptr, nullptr, nullptr, nullptr, &advance) == 0, debug::last_error());
+
+    glyph g { 0, { 0, 0, 0, 0 }, static_cast<pixel_t>(advance) };
+
+    surface surf { fnt.render(ch).fg(fg).bg(bg)(rt) };
+
+    if (surf.pixel_format() != pixel::format::rgba32)
+        surf = surf.convert(pixel::format::rgba32);
+
+    const pixel::point size { surf.size() };
+
+    if (size.x > 0 && size.y > 0)
+    {
+        // Leave a pixel of padding so that filtering doesn't pick up neighbouring glyphs.
+        const pixel::point padded { size.x + 1, size.y + 1 };
+
+        std::optional<pixel::point> pos;
+
+        for (; g.page < m_packers.size() && !pos; ++g.page)
+            pos = m_packers[g.page].insert(padded);
+
+        if (pos)
+            --g.page;
+
+        else
+        {
+            add_page();
+            pos = m_packers.back().insert(padded);
+
+            HAL_ASSERT_VITAL(pos.has_value(), "Glyph too large for glyph cache page");
+        }
+
+        g.area = { *pos, size };
+
+        HAL_ASSERT_VITAL(::SDL_UpdateTexture(m_pages[g.page].get(), g.area.addr(), surf.get()->pixels, surf.get()->pitch) == 0, debug::last_error());
+    }
+
+    return m_glyphs.emplace(k, g).first->second;
+}
+
+pixel::point glyph_cache::size_text(view<const font> fnt, std::string_view text, font::render_type rt)
+{
+    const pixel_t skip { fnt.skip() };
+
+    pixel::point size { 0, 0 }, pen { 0, 0 };
+    char32_t     prev { 0 };
+
+    while (!text.empty())
+    {
+        const char32_t ch { pop_codepoint(text) };
+
+        if (ch == U'\n')
+        {
+            pen  = { 0, pen.y + skip };
+            prev = 0;
+
+            continue;
+        }
+
+        if (prev != 0)
+            pen.x += static_cast<pixel_t>(::TTF_GetFontKerningSizeGlyphs32(fnt.get(), prev, ch));
+
+        pen.x += get(fnt, ch, rt).advance;
+        prev = ch;
+
+        size.x = std::max(size.x, pen.x);
+        size.y = pen.y + fnt.height();
+    }
+
+    return size;
+}
+
+void glyph_cache::clear()
+{
+    m_glyphs.clear();
+
+    for (detail::skyline& packer : m_packers)
+        packer.clear();
+}
+
+std::size_t glyph_cache::size() const
+{
+    return m_glyphs.size();
+}
+
+u32 glyph_cache::pages() const
+{
+    return static_cast<u32>(m_pages.size());
+}
+
+void glyph_cache::add_page()
+{
+    target_texture& page { m_pages.emplace_back(m_rnd, pixel::format::rgba32, m_pageSize) };
+
+    m_packers.emplace_back(m_pageSize);
+    m_batches.push_back(m_rnd.make_sprite_batch(page));
+
+    // Target textures start out with undefined contents; clear this one to transparent
+    // without disturbing the caller's render target or draw color.
+    const view<texture> prev_target { m_rnd.target() };
+    const color         prev_color { m_rnd.color() };
+
+    m_rnd.target(page);
+    m_rnd.color(palette::transparent);
+    m_rnd.clear();
+
+    m_rnd.target(prev_target);
+    m_rnd.color(prev_color);
+}
+
+std::size_t glyph_cache::key_hash::operator()(const key& k) const
+{
+    const u64 lo { (static_cast<u64>(k.ch) << 8) | std::to_underlying(k.type) };
+    const u64 hi { (static_cast<u64>(pack(k.fg)) << 32) | pack(k.bg) };
+
+    std::size_t seed { std::hash<const void*> {}(k.fnt) };
+
+    for (const u64 v : { lo, hi })
+        seed ^= std::hash<u64> {}(v) + 0x9E3779B97F4A7C15 + (seed << 6) + (seed >> 2);
+
+    return seed;
+}
\ No newline at end of file
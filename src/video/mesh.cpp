@@ -0,0 +1,109 @@
+#include <halcyon/video/mesh.hpp>
+
+#include <algorithm>
+
+#include <halcyon/debug.hpp>
+
+using namespace hal;
+
+mesh::mesh(std::size_t vertices)
+{
+    resize(vertices);
+}
+
+mesh::index_t mesh::push(coord::point pos, color c, coord::point uv)
+{
+    m_positions.push_back(pos);
+    m_colors.push_back(c);
+    m_uvs.push_back(uv);
+
+    return static_cast<index_t>(m_positions.size() - 1);
+}
+
+void mesh::push(index_t a, index_t b, index_t c)
+{
+    HAL_ASSERT(a >= 0 && b >= 0 && c >= 0 && static_cast<std::size_t>(std::max({ a, b, c })) < size(), "Mesh index out of range");
+
+    m_indices.insert(m_indices.end(), { a, b, c });
+}
+
+void mesh::push(index_t a, index_t b, index_t c, index_t d)
+{
+    push(a, b, c);
+    push(c, d, a);
+}
+
+void mesh::resize(std::size_t vertices)
+{
+    m_positions.resize(vertices, { 0.0f, 0.0f });
+    m_colors.resize(vertices, palette::white);
+    m_uvs.resize(vertices, { 0.0f, 0.0f });
+}
+
+void mesh::resize_indices(std::size_t count)
+{
+    m_indices.resize(count, 0);
+}
+
+void mesh::reserve(std::size_t vertices, std::size_t indices)
+{
+    m_positions.reserve(vertices);
+    m_colors.reserve(vertices);
+    m_uvs.reserve(vertices);
+
+    m_indices.reserve(indices);
+}
+
+void mesh::clear()
+{
+    m_positions.clear();
+    m_colors.clear();
+    m_uvs.clear();
+
+    m_indices.clear();
+}
+
+std::span<coord::point> mesh::positions()
+{
+    return m_positions;
+}
+
+std::span<const coord::point> mesh::positions() const
+{
+    return m_positions;
+}
+
+std::span<color> mesh::colors()
+{
+    return m_colors;
+}
+
+std::span<const color> mesh::colors() const
+{
+    return m_colors;
+}
+
+std::span<coord::point> mesh::uvs()
+{
+    return m_uvs;
+}
+
+std::span<const coord::point> mesh::uvs() const
+{
+    return m_uvs;
+}
+
+std::span<mesh::index_t> mesh::indices()
+{
+    return m_indices;
+}
+
+std::span<const mesh::index_t> mesh::indices() const
+{
+    return m_indices;
+}
+
+std::size_t mesh::size() const
+{
+    return m_positions.size();
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <halcyon/video/primitive_batch.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <halcyon/profiler.hpp>
+
+#include <halcyon/video/sprite_batch.hpp>
+
+using namespace hal;
+
+namespace
+{
+    // Vertices per quad, indices per quad.
+    constexpr std::size_t vps { 4 }, ips { 6 };
+}
+
+primitive_batch::primitive_batch(view<renderer> rnd, pass_key<view<renderer>>)
+    : m_rnd { rnd }
+{
+}
+
+void primitive_batch::point(coord::point pt, color c)
+{
+    fill({ pt.x, pt.y, 1.0f, 1.0f }, c);
+}
+
+void primitive_batch::line(coord::point from, coord::point to, color c)
+{
+    const coord::point dir { to.x - from.x, to.y - from.y };
+    const f32          len { std::sqrt(dir.x * dir.x + dir.y * dir.y) };
+
+    if (len == 0.0f)
+    {
+        point(from, c);
+        return;
+    }
+
+    // Half a pixel to each side; pixel centers are offset by another half.
+    const coord::point side { -dir.y / len * 0.5f, dir.x / len * 0.5f };
+    const coord::point a { from.x + 0.5f, from.y + 0.5f }, b { to.x + 0.5f, to.y + 0.5f };
+
+    quad({ a.x + side.x, a.y + side.y }, { b.x + side.x, b.y + side.y }, { b.x - side.x, b.y - side.y }, { a.x - side.x, a.y - side.y }, c);
+}
+
+void primitive_batch::outline(const coord::rect& area, color c)
+{
+    const coord_t inner { std::max(area.size.y - 2.0f, 0.0f) };
+
+    fill({ area.pos.x, area.pos.y, area.size.x, 1.0f }, c);
+    fill({ area.pos.x, area.pos.y + area.size.y - 1.0f, area.size.x, 1.0f }, c);
+    fill({ area.pos.x, area.pos.y + 1.0f, 1.0f, inner }, c);
+    fill({ area.pos.x + area.size.x - 1.0f, area.pos.y + 1.0f, 1.0f, inner }, c);
+}
+
+void primitive_batch::fill(const coord::rect& area, color c)
+{
+    const coord::point end { area.pos.x + area.size.x, area.pos.y + area.size.y };
+
+    quad(area.pos, { end.x, area.pos.y }, end, { area.pos.x, end.y }, c);
+}
+
+void primitive_batch::reserve(std::size_t quads)
+{
+    m_vertices.reserve(quads * vps);
+    detail::grow_quad_indices(m_indices, quads);
+}
+
+void primitive_batch::flush()
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (m_vertices.empty())
+        return;
+
+    const std::size_t quads { size() };
+
+    detail::grow_quad_indices(m_indices, quads);
+
+    HAL_ASSERT_VITAL(::SDL_RenderGeometry(m_rnd.get(), nullptr, m_vertices.data(), static_cast<int>(m_vertices.size()), m_indices.data(), static_cast<int>(quads * ips)) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+
+    clear();
+}
+
+void primitive_batch::clear()
+{
+    m_vertices.clear();
+}
+
+std::size_t primitive_batch::size() const
+{
+    return m_vertices.size() / vps;
+}
+
+void primitive_batch::quad(coord::point a, coord::point b, coord::point c, coord::point d, color clr)
+{
+    const SDL_Color sdl_clr { static_cast<SDL_Color>(clr) };
+
+    for (const coord::point& p : { a, b, c, d })
+        m_vertices.push_back({ { p.x, p.y }, sdl_clr, { 0.0f, 0.0f } });
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include <halcyon/video/render_queue.hpp>
+
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include <halcyon/video/sprite_batch.hpp>
+
+#include <halcyon/profiler.hpp>
+
+using namespace hal;
+
+// Queued sprite.
+
+queued_sprite::queued_sprite(render_queue& queue, view<renderer> rnd, view<const texture> tex, pass_key<render_queue>)
+    : drawer { rnd, tex }
+    , m_queue { queue }
+{
+}
+
+queued_sprite& queued_sprite::layer(u8 l)
+{
+    m_layer = l;
+    return *this;
+}
+
+queued_sprite& queued_sprite::depth(u16 d)
+{
+    m_depth = d;
+    return *this;
+}
+
+queued_sprite& queued_sprite::rotate(f64 angle)
+{
+    m_angle = angle;
+    return *this;
+}
+
+queued_sprite& queued_sprite::flip(enum flip f)
+{
+    m_flip = f;
+    return *this;
+}
+
+queued_sprite& queued_sprite::tint(color c)
+{
+    m_tint = c;
+    return *this;
+}
+
+void queued_sprite::operator()()
+{
+    m_queue.push(m_this, m_src, m_dst, m_layer, m_depth, m_angle, m_flip, m_tint);
+}
+
+// Render queue.
+
+namespace
+{
+    // Vertices per sprite, indices per sprite.
+    constexpr std::size_t vps { 4 }, ips { 6 };
+
+    constexpr coord_t unset_dst { std::numeric_limits<coord_t>::max() };
+
+    // Sort key layout, from the most significant bit.
+    constexpr int layer_shift { 56 }, blend_shift { 52 }, texture_shift { 32 }, depth_shift { 16 };
+
+    constexpr u32 max_textures { 1 << (blend_shift - texture_shift) };
+
+    // Group blend modes into a few bits.
+    u8 blend_rank(blend_mode bm)
+    {
+        switch (bm)
+        {
+            using enum blend_mode;
+
+        case none:
+            return 0;
+
+        case blend:
+            return 1;
+
+        case add:
+            return 2;
+
+        case mod:
+            return 3;
+
+        case mul:
+            return 4;
+
+        default:
+            return 5;
+        }
+    }
+}
+
+render_queue::render_queue(view<renderer> rnd, pass_key<view<renderer>>)
+    : m_rnd { rnd }
+{
+    m_rnd.attach(*this, pass_key<render_queue> {});
+}
+
+render_queue::~render_queue()
+{
+    m_rnd.detach(*this, pass_key<render_queue> {});
+}
+
+queued_sprite render_queue::draw(view<const hal::texture> tex)
+{
+    return { *this, m_rnd, tex, pass_key<render_queue> {} };
+}
+
+void render_queue::push(view<const hal::texture> tex, const pixel::rect& src, const coord::rect& dst, u8 layer, u16 depth, f64 angle, enum flip f, color tint)
+{
+    const u32 id { texture_id(tex) };
+
+    u64 key { static_cast<u64>(layer) << layer_shift };
+
+    // Stable sorting keeps submission order among equal keys, so ordered layers sort by layer alone.
+    if (!m_ordered[layer])
+        key |= static_cast<u64>(m_textures[id].blend) << blend_shift | static_cast<u64>(id) << texture_shift | static_cast<u64>(depth) << depth_shift;
+
+    m_keys.push_back(key);
+    m_sprites.push_back({ src, dst.pos.x == unset_dst ? coord::rect { coord::point {}, coord::point(m_rnd.size()) } : dst, angle, id, tint, f });
+}
+
+void render_queue::ordered(u8 layer, bool keep_order)
+{
+    m_ordered[layer] = keep_order;
+}
+
+bool render_queue::ordered(u8 layer) const
+{
+    return m_ordered[layer];
+}
+
+void render_queue::flush()
+{
+    HAL_PROFILE_FUNCTION();
+
+    m_drawCalls = 0;
+
+    if (m_sprites.empty())
+        return;
+
+    sort();
+
+    m_vertices.clear();
+    m_vertices.reserve(m_sprites.size() * vps);
+
+    for (const u32 idx : m_order)
+    {
+        const sprite& s { m_sprites[idx] };
+
+        detail::append_quad(m_vertices, s.src, s.dst, m_textures[s.tex].size, s.angle, s.f, s.tint);
+    }
+
+    // Submit runs of sprites sharing a texture.
+    for (std::size_t begin { 0 }, end { 0 }; begin < m_order.size(); begin = end)
+    {
+        const u32 tex { m_sprites[m_order[begin]].tex };
+
+        while (end < m_order.size() && m_sprites[m_order[end]].tex == tex)
+            ++end;
+
+        const std::size_t count { end - begin };
+
+        detail::grow_quad_indices(m_indices, count);
+
+        HAL_ASSERT_VITAL(::SDL_RenderGeometry(m_rnd.get(), m_textures[tex].tex.get(), m_vertices.data() + begin * vps, static_cast<int>(count * vps), m_indices.data(), static_cast<int>(count * ips)) == 0, debug::last_error());
+        HAL_PROFILE_COUNT(draw_calls, 1);
+
+        ++m_drawCalls;
+    }
+
+    clear();
+}
+
+void render_queue::clear()
+{
+    m_sprites.clear();
+    m_keys.clear();
+    m_textures.clear();
+    m_textureIds.clear();
+}
+
+std::size_t render_queue::size() const
+{
+    return m_sprites.size();
+}
+
+std::size_t render_queue::draw_calls() const
+{
+    return m_drawCalls;
+}
+
+u32 render_queue::texture_id(view<const hal::texture> tex)
+{
+    const auto [it, inserted] = m_textureIds.try_emplace(tex.get(), static_cast<u32>(m_textures.size()));
+
+    if (inserted)
+    {
+        HAL_ASSERT(m_textures.size() < max_textures, "Too many textures in a render queue");
+
+        m_textures.push_back({ tex, coord::point(tex.size()), blend_rank(tex.blend()) });
+    }
+
+    return it->second;
+}
+
+void render_queue::sort()
+{
+    const std::size_t n { m_keys.size() };
+
+    m_sortKeys.assign(m_keys.begin(), m_keys.end());
+    m_tmpKeys.resize(n);
+
+    m_order.resize(n);
+    m_tmpOrder.resize(n);
+
+    std::iota(m_order.begin(), m_order.end(), u32 { 0 });
+
+    // Least significant digit first; each pass is stable, so the whole sort is too.
+    for (int shift { 0 }; shift < 64; shift += 8)
+    {
+        std::array<std::size_t, 257> offsets {};
+
+        for (const u64 k : m_sortKeys)
+            ++offsets[((k >> shift) & 0xFF) + 1];
+
+        // Skip digits that are the same for every key, which is most of them.
+        if (offsets[((m_sortKeys.front() >> shift) & 0xFF) + 1] == n)
+            continue;
+
+        for (std::size_t i { 1 }; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+
+        for (std::size_t i { 0 }; i < n; ++i)
+        {
+            const std::size_t dst { offsets[(m_sortKeys[i] >> shift) & 0xFF]++ };
+
+            m_tmpKeys[dst]  = m_sortKeys[i];
+            m_tmpOrder[dst] = m_order[i];
+        }
+
+        m_sortKeys.swap(m_tmpKeys);
+        m_order.swap(m_tmpOrder);
+    }
+}
\ No newline at end of file
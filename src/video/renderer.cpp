@@ -1,7 +1,17 @@
 #include <halcyon/video/renderer.hpp>
 
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include <halcyon/surface.hpp>
 
+#include <halcyon/profiler.hpp>
+
+#include <halcyon/video/mesh.hpp>
+#include <halcyon/video/primitive_batch.hpp>
+#include <halcyon/video/render_queue.hpp>
+#include <halcyon/video/sprite_batch.hpp>
 #include <halcyon/video/texture.hpp>
 #include <halcyon/video/window.hpp>
 
@@ -9,6 +19,38 @@
 
 using namespace hal;
 
+namespace
+{
+    // Renderer state as last set through Halcyon, so that redundant SDL calls can be skipped.
+    // Anything that hasn't been set yet is queried from SDL.
+    // The render target isn't cached: SDL resets it when the target texture is destroyed,
+    // so its own value is the only one that can be trusted.
+    struct shadow_state
+    {
+        const SDL_Renderer* rnd;
+
+        std::optional<color>      clr;
+        std::optional<blend_mode> bm;
+
+        // Render queues to flush before presenting.
+        std::vector<render_queue*> queues;
+
+        elided_calls frame, last;
+    };
+
+    // Renderers may only be used from the thread that created them, so every thread gets its own table.
+    thread_local std::vector<shadow_state> states;
+
+    shadow_state& state_of(const SDL_Renderer* rnd)
+    {
+        for (shadow_state& s : states)
+            if (s.rnd == rnd)
+                return s;
+
+        return states.emplace_back(rnd);
+    }
+}
+
 using cv = view<const renderer>;
 
 pixel::point cv::size() const
@@ -24,20 +66,34 @@ pixel::point cv::size() const
 
 color cv::color() const
 {
-    hal::color ret;
+    shadow_state& state { state_of(get()) };
+
+    if (!state.clr.has_value())
+    {
+        hal::color ret;
 
-    HAL_ASSERT_VITAL(::SDL_GetRenderDrawColor(get(), &ret.r, &ret.g, &ret.b, &ret.a) == 0, debug::last_error());
+        HAL_ASSERT_VITAL(::SDL_GetRenderDrawColor(get(), &ret.r, &ret.g, &ret.b, &ret.a) == 0, debug::last_error());
 
-    return ret;
+        state.clr = ret;
+    }
+
+    return *state.clr;
 }
 
 blend_mode cv::blend() const
 {
-    SDL_BlendMode bm;
+    shadow_state& state { state_of(get()) };
+
+    if (!state.bm.has_value())
+    {
+        SDL_BlendMode bm;
 
-    HAL_ASSERT_VITAL(::SDL_GetRenderDrawBlendMode(get(), &bm) == 0, debug::last_error());
+        HAL_ASSERT_VITAL(::SDL_GetRenderDrawBlendMode(get(), &bm) == 0, debug::last_error());
 
-    return static_cast<blend_mode>(bm);
+        state.bm = static_cast<blend_mode>(bm);
+    }
+
+    return *state.bm;
 }
 
 info::sdl::renderer cv::info() const
@@ -50,47 +106,169 @@ view<const window> cv::window() const
     return { *this, pass_key<cv> {} };
 }
 
+elided_calls cv::elided_calls() const
+{
+    return state_of(get()).last;
+}
+
 using v = view<renderer>;
 
 void v::present()
 {
-    ::SDL_RenderPresent(get());
+    present(tag::no_clear);
     this->clear();
 }
 
+void v::present(HAL_TAG_NAME(no_clear))
+{
+    HAL_PROFILE_FUNCTION();
+
+    shadow_state& state { state_of(get()) };
+
+    // Empty queues are skipped, so that their last flush's draw call count stays.
+    for (render_queue* q : state.queues)
+        if (q->size() != 0)
+            q->flush();
+
+    ::SDL_RenderPresent(get());
+
+    HAL_PROFILE_FRAME();
+
+    state.frame.texture_mods = detail::take_elided_texture_mods(get());
+    state.last               = std::exchange(state.frame, {});
+}
+
+void v::attach(render_queue& q, pass_key<render_queue>)
+{
+    state_of(get()).queues.push_back(&q);
+}
+
+void v::detach(render_queue& q, pass_key<render_queue>)
+{
+    // Not through state_of(), as the renderer may already be gone.
+    for (shadow_state& s : states)
+        if (s.rnd == get())
+            std::erase(s.queues, &q);
+}
+
 void v::clear()
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_RenderClear(get()) == 0, debug::last_error());
 }
 
 void v::draw(coord::point pt)
 {
+    HAL_PROFILE_FUNCTION();
+
     ::SDL_RenderDrawPointF(get(), pt.x, pt.y);
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
 
 void v::draw(coord::point from, coord::point to)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_RenderDrawLineF(get(), from.x, from.y, to.x, to.y) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
 
 void v::draw(coord::rect area)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_RenderDrawRectF(get(), area.addr()) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
 
 void v::fill(coord::rect area)
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_RenderFillRectF(get(), area.addr()) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+}
+
+void v::draw_points(std::span<const coord::point> pts)
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (pts.empty())
+        return;
+
+    HAL_ASSERT_VITAL(::SDL_RenderDrawPointsF(get(), pts.front().addr(), static_cast<int>(pts.size())) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+}
+
+void v::draw_lines(std::span<const coord::point> pts)
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (pts.size() < 2)
+        return;
+
+    HAL_ASSERT_VITAL(::SDL_RenderDrawLinesF(get(), pts.front().addr(), static_cast<int>(pts.size())) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+}
+
+void v::draw_rects(std::span<const coord::rect> areas)
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (areas.empty())
+        return;
+
+    HAL_ASSERT_VITAL(::SDL_RenderDrawRectsF(get(), areas.front().addr(), static_cast<int>(areas.size())) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+}
+
+void v::draw(const mesh& m, view<const texture> tex)
+{
+    HAL_PROFILE_FUNCTION();
+
+    static_assert(sizeof(hal::color) == sizeof(SDL_Color) && sizeof(coord::point) == sizeof(float) * 2);
+
+    if (m.size() == 0)
+        return;
+
+    const std::span<const mesh::index_t> idx { m.indices() };
+
+    HAL_ASSERT_VITAL(::SDL_RenderGeometryRaw(get(), tex.get(),
+                         &m.positions().front().x, sizeof(coord::point),
+                         m.colors().data(), sizeof(hal::color),
+                         &m.uvs().front().x, sizeof(coord::point),
+                         static_cast<int>(m.size()),
+                         idx.empty() ? nullptr : idx.data(), static_cast<int>(idx.size()), sizeof(mesh::index_t))
+            == 0,
+        debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
 
 void v::fill(std::span<const coord::rect> areas)
 {
+    HAL_PROFILE_FUNCTION();
+
+    if (areas.empty())
+        return;
+
     HAL_ASSERT_VITAL(::SDL_RenderFillRectsF(get(), areas.front().addr(), static_cast<int>(areas.size())) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
 
 void v::fill()
 {
+    HAL_PROFILE_FUNCTION();
+
     HAL_ASSERT_VITAL(::SDL_RenderFillRect(get(), nullptr) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+}
+
+view<texture> v::target()
+{
+    SDL_Texture* const tgt { ::SDL_GetRenderTarget(get()) };
+
+    return tgt != nullptr ? view<texture> { tgt, pass_key<v> {} } : view<texture> {};
 }
 
 void v::target(target_texture& tx)
@@ -98,6 +276,11 @@ void v::target(target_texture& tx)
     this->internal_target(tx.get());
 }
 
+void v::target(view<texture> tx)
+{
+    this->internal_target(tx.get());
+}
+
 void v::reset_target()
 {
     this->internal_target(nullptr);
@@ -120,9 +303,18 @@ view<window> v::window()
 
 static_texture v::make_texture(view<const surface> surf) &
 {
+    HAL_PROFILE_FUNCTION();
+
     return { *this, surf };
 }
 
+mip_texture v::make_texture(view<const surface> surf, HAL_TAG_NAME(mipmapped), enum filter f) &
+{
+    HAL_PROFILE_FUNCTION();
+
+    return { *this, surf, f };
+}
+
 target_texture v::make_target_texture(pixel::point size) &
 {
     SDL_Window* wnd { ::SDL_RenderGetWindow(get()) };
@@ -134,14 +326,59 @@ target_texture v::make_target_texture(pixel::point size) &
     return { *this, fmt, size };
 }
 
+streaming_texture v::make_streaming_texture(pixel::point size, pixel::format fmt) &
+{
+    return { *this, fmt, size };
+}
+
+buffered_texture v::make_buffered_texture(pixel::point size, pixel::format fmt) &
+{
+    return { *this, fmt, size };
+}
+
+sprite_batch v::make_sprite_batch(view<const texture> tex) &
+{
+    return { *this, tex, pass_key<v> {} };
+}
+
+render_queue v::make_render_queue() &
+{
+    return { *this, pass_key<v> {} };
+}
+
+primitive_batch v::make_primitive_batch() &
+{
+    return { *this, pass_key<v> {} };
+}
+
 void v::color(hal::color clr)
 {
+    shadow_state& state { state_of(get()) };
+
+    if (state.clr == clr)
+    {
+        ++state.frame.color;
+        return;
+    }
+
     HAL_ASSERT_VITAL(::SDL_SetRenderDrawColor(get(), clr.r, clr.g, clr.b, clr.a) == 0, debug::last_error());
+
+    state.clr = clr;
 }
 
 void v::blend(blend_mode bm)
 {
+    shadow_state& state { state_of(get()) };
+
+    if (state.bm == bm)
+    {
+        ++state.frame.blend;
+        return;
+    }
+
     HAL_ASSERT_VITAL(::SDL_SetRenderDrawBlendMode(get(), SDL_BlendMode(bm)) == 0, debug::last_error());
+
+    state.bm = bm;
 }
 
 copyer v::render(view<const texture> tex)
@@ -149,14 +386,29 @@ copyer v::render(view<const texture> tex)
     return { *this, tex };
 }
 
+copyer v::render(const mip_texture& tex)
+{
+    return { *this, tex, pass_key<v> {} };
+}
+
 void v::internal_target(SDL_Texture* target)
 {
+    if (::SDL_GetRenderTarget(get()) == target)
+    {
+        ++state_of(get()).frame.target;
+        return;
+    }
+
     HAL_ASSERT_VITAL(::SDL_SetRenderTarget(get(), target) == 0, debug::last_error());
 }
 
 renderer::renderer(view<const class window> wnd, std::initializer_list<flags> f)
     : raii_object { ::SDL_CreateRenderer(wnd.get(), -1, detail::to_bitmask<std::uint32_t>(f)) }
 {
+    // A previous renderer might have had the same address.
+    state_of(get()) = shadow_state { get(), std::nullopt, std::nullopt, {}, {}, {} };
+    detail::take_elided_texture_mods(get());
+
     HAL_PRINT("Created renderer for \"", wnd.title(), "\" ");
 }
 
@@ -226,6 +478,12 @@ info::renderer::renderer(const sdl::renderer& src)
 
 // Copyer.
 
+copyer::copyer(view<renderer> rnd, const mip_texture& tex, pass_key<view<renderer>>)
+    : drawer { rnd, tex.level(0), coord::point(tex.size()) }
+    , m_mips { &tex }
+{
+}
+
 copyer& copyer::rotate(f64 angle)
 {
     m_angle = angle;
@@ -252,10 +510,34 @@ copyer& copyer::outline(color c)
 
 void copyer::operator()()
 {
-    HAL_ASSERT_VITAL(::SDL_RenderCopyExF(m_pass.get(), m_this.get(),
-                         m_src.pos.x == unset_pos<src_t>() ? nullptr : m_src.addr(),
+    HAL_PROFILE_FUNCTION();
+
+    view<const texture> tex { m_this };
+    src_rect            src { m_src };
+
+    const bool has_src { m_src.pos.x != unset_pos<src_t>() };
+
+    if (m_mips != nullptr)
+    {
+        const pixel::point full { m_mips->size() };
+        const std::size_t  lvl { m_mips->level_for(has_src ? m_src.size : full, m_dst.pos.x == unset_pos<dst_t>() ? coord::point(m_pass.size()) : m_dst.size) };
+        const pixel::point lvl_size { m_mips->level_size(lvl) };
+
+        tex = m_mips->level(lvl);
+
+        // Source rectangles are given in full-size coordinates.
+        if (has_src && lvl != 0)
+        {
+            src.pos  = { static_cast<src_t>(m_src.pos.x * lvl_size.x / full.x), static_cast<src_t>(m_src.pos.y * lvl_size.y / full.y) };
+            src.size = { std::max<src_t>(m_src.size.x * lvl_size.x / full.x, 1), std::max<src_t>(m_src.size.y * lvl_size.y / full.y, 1) };
+        }
+    }
+
+    HAL_ASSERT_VITAL(::SDL_RenderCopyExF(m_pass.get(), tex.get(),
+                         has_src ? src.addr() : nullptr,
                          m_dst.pos.x == unset_pos<dst_t>() ? nullptr : m_dst.addr(),
                          m_angle, nullptr, static_cast<SDL_RendererFlip>(m_flip))
             == 0,
         debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <halcyon/video/sprite_batch.hpp>
+
+#include <cmath>
+#include <numbers>
+
+#include <halcyon/profiler.hpp>
+
+using namespace hal;
+
+// Batch sprite.
+
+batch_sprite::batch_sprite(sprite_batch& batch, view<renderer> rnd, view<const texture> tex, coord::point tex_size, pass_key<sprite_batch>)
+    : drawer { rnd, tex, tex_size }
+    , m_batch { batch }
+{
+}
+
+batch_sprite& batch_sprite::rotate(f64 angle)
+{
+    m_angle = angle;
+    return *this;
+}
+
+batch_sprite& batch_sprite::flip(enum flip f)
+{
+    m_flip = f;
+    return *this;
+}
+
+batch_sprite& batch_sprite::tint(color c)
+{
+    m_tint = c;
+    return *this;
+}
+
+void batch_sprite::operator()()
+{
+    m_batch.push(m_src, m_dst, m_angle, m_flip, m_tint);
+}
+
+// Sprite batch.
+
+namespace
+{
+    // Vertices per sprite, indices per sprite.
+    constexpr std::size_t vps { 4 }, ips { 6 };
+
+    constexpr pixel_t unset_src { std::numeric_limits<pixel_t>::max() };
+    constexpr coord_t unset_dst { std::numeric_limits<coord_t>::max() };
+}
+
+sprite_batch::sprite_batch(view<hal::renderer> rnd, view<const hal::texture> tex, pass_key<view<hal::renderer>>)
+    : m_rnd { rnd }
+    , m_tex { tex }
+    , m_texSize { static_cast<coord::point>(tex.size()) }
+{
+}
+
+batch_sprite sprite_batch::draw()
+{
+    return { *this, m_rnd, m_tex, m_texSize, pass_key<sprite_batch> {} };
+}
+
+void sprite_batch::push(const pixel::rect& src, const coord::rect& dst, f64 angle, enum flip f, color tint)
+{
+    detail::append_quad(m_vertices, src, dst.pos.x == unset_dst ? coord::rect { coord::point {}, coord::point(m_rnd.size()) } : dst, m_texSize, angle, f, tint);
+}
+
+void sprite_batch::reserve(std::size_t sprites)
+{
+    m_vertices.reserve(sprites * vps);
+    detail::grow_quad_indices(m_indices, sprites);
+}
+
+void sprite_batch::flush()
+{
+    HAL_PROFILE_FUNCTION();
+
+    if (m_vertices.empty())
+        return;
+
+    const std::size_t sprites { size() };
+
+    detail::grow_quad_indices(m_indices, sprites);
+
+    HAL_ASSERT_VITAL(::SDL_RenderGeometry(m_rnd.get(), m_tex.get(), m_vertices.data(), static_cast<int>(m_vertices.size()), m_indices.data(), static_cast<int>(sprites * ips)) == 0, debug::last_error());
+    HAL_PROFILE_COUNT(draw_calls, 1);
+
+    clear();
+}
+
+void sprite_batch::clear()
+{
+    m_vertices.clear();
+}
+
+std::size_t sprite_batch::size() const
+{
+    return m_vertices.size() / vps;
+}
+
+view<const texture> sprite_batch::texture() const
+{
+    return m_tex;
+}
+
+// Quad helpers.
+
+void detail::append_quad(std::vector<SDL_Vertex>& vertices, const pixel::rect& src, const coord::rect& dst, coord::point tex_size, f64 angle, enum flip f, color tint)
+{
+    // Texture coordinates.
+    coord::point uv0 { 0.0f, 0.0f }, uv1 { 1.0f, 1.0f };
+
+    if (src.pos.x != unset_src)
+    {
+        uv0 = coord::point(src.pos) / tex_size;
+        uv1 = coord::point(src.pos + src.size) / tex_size;
+    }
+
+    if (f == flip::x || f == flip::both)
+        std::swap(uv0.x, uv1.x);
+
+    if (f == flip::y || f == flip::both)
+        std::swap(uv0.y, uv1.y);
+
+    // Corners relative to the center, clockwise from the top left. Same pivot as SDL_RenderCopyEx.
+    const coord::point half { dst.size / 2.0f };
+    const coord::point center { dst.pos + half };
+
+    coord::point corners[vps] {
+        { -half.x, -half.y },
+        { half.x, -half.y },
+        { half.x, half.y },
+        { -half.x, half.y }
+    };
+
+    if (angle != 0.0)
+    {
+        const f64 rad { angle * std::numbers::pi / 180.0 };
+        const f32 sin { static_cast<f32>(std::sin(rad)) }, cos { static_cast<f32>(std::cos(rad)) };
+
+        for (coord::point& c : corners)
+            c = { c.x * cos - c.y * sin, c.x * sin + c.y * cos };
+    }
+
+    const coord::point uvs[vps] {
+        uv0,
+        { uv1.x, uv0.y },
+        uv1,
+        { uv0.x, uv1.y }
+    };
+
+    for (std::size_t i { 0 }; i < vps; ++i)
+    {
+        const coord::point pos { center + corners[i] };
+
+        vertices.push_back({ { pos.x, pos.y }, static_cast<SDL_Color>(tint), { uvs[i].x, uvs[i].y } });
+    }
+}
+
+void detail::grow_quad_indices(std::vector<int>& indices, std::size_t quads)
+{
+    const std::size_t built { indices.size() / ips };
+
+    if (quads <= built)
+        return;
+
+    indices.reserve(quads * ips);
+
+    for (std::size_t i { built }; i < quads; ++i)
+    {
+        const int base { static_cast<int>(i * vps) };
+
+        for (const int offset : { 0, 1, 2, 2, 3, 0 })
+            indices.push_back(base + offset);
+    }
+}
\ No newline at end of file
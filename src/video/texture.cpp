@@ -1,11 +1,81 @@
 #include <halcyon/video/texture.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <halcyon/debug.hpp>
+#include <halcyon/profiler.hpp>
 #include <halcyon/surface.hpp>
 #include <halcyon/video/renderer.hpp>
 
 using namespace hal;
 
+namespace
+{
+    int bytes_per_pixel(pixel::format fmt)
+    {
+        return static_cast<int>(SDL_BYTESPERPIXEL(static_cast<Uint32>(fmt)));
+    }
+
+    // Texture modifiers as last set through Halcyon, so that redundant SDL calls can be skipped.
+    // Anything that hasn't been set yet is queried from SDL.
+    struct shadow_state
+    {
+        // Charged with skipped calls. Null for textures that weren't created by Halcyon.
+        const SDL_Renderer* rnd { nullptr };
+
+        std::optional<color::value_t> alpha;
+        std::optional<color>          clr; // Alpha is unused.
+        std::optional<blend_mode>     bm;
+    };
+
+    // Textures may only be used from their renderer's thread, so every thread gets its own tables.
+    thread_local std::unordered_map<const SDL_Texture*, shadow_state> states;
+
+    // Skipped calls per renderer since its last present.
+    thread_local std::vector<std::pair<const SDL_Renderer*, u32>> elided;
+
+    shadow_state& state_of(const SDL_Texture* tex)
+    {
+        return states[tex];
+    }
+
+    // Skip a modifier call that wouldn't change anything.
+    bool elide(const shadow_state& state, bool unchanged)
+    {
+        if (unchanged && state.rnd != nullptr)
+        {
+            const auto it { std::ranges::find(elided, state.rnd, &std::pair<const SDL_Renderer*, u32>::first) };
+
+            if (it != elided.end())
+                ++it->second;
+
+            else
+                elided.emplace_back(state.rnd, 1);
+        }
+
+        return unchanged;
+    }
+}
+
+u32 detail::take_elided_texture_mods(const SDL_Renderer* rnd)
+{
+    const auto it { std::ranges::find(elided, rnd, &std::pair<const SDL_Renderer*, u32>::first) };
+
+    return it != elided.end() ? std::exchange(it->second, 0) : 0;
+}
+
+void detail::destroy_texture(SDL_Texture* tex)
+{
+    states.erase(tex);
+
+    ::SDL_DestroyTexture(tex);
+}
+
 using cv = view<const texture>;
 
 pixel::point cv::size() const
@@ -19,29 +89,50 @@ pixel::point cv::size() const
 
 color::value_t cv::alpha_mod() const
 {
-    color::value_t ret;
+    shadow_state& state { state_of(get()) };
 
-    ::SDL_GetTextureAlphaMod(get(), &ret);
+    if (!state.alpha.has_value())
+    {
+        color::value_t ret;
 
-    return ret;
+        HAL_ASSERT_VITAL(::SDL_GetTextureAlphaMod(get(), &ret) == 0, debug::last_error());
+
+        state.alpha = ret;
+    }
+
+    return *state.alpha;
 }
 
 color cv::color_mod() const
 {
-    color c;
+    shadow_state& state { state_of(get()) };
+
+    if (!state.clr.has_value())
+    {
+        color c;
+
+        HAL_ASSERT_VITAL(::SDL_GetTextureColorMod(get(), &c.r, &c.g, &c.b) == 0, debug::last_error());
 
-    HAL_ASSERT_VITAL(::SDL_GetTextureColorMod(get(), &c.r, &c.g, &c.b) == 0, debug::last_error());
+        state.clr = c;
+    }
 
-    return c;
+    return *state.clr;
 }
 
 blend_mode cv::blend() const
 {
-    SDL_BlendMode bm;
+    shadow_state& state { state_of(get()) };
 
-    HAL_ASSERT_VITAL(::SDL_GetTextureBlendMode(get(), &bm) == 0, debug::last_error());
+    if (!state.bm.has_value())
+    {
+        SDL_BlendMode bm;
 
-    return blend_mode(bm);
+        HAL_ASSERT_VITAL(::SDL_GetTextureBlendMode(get(), &bm) == 0, debug::last_error());
+
+        state.bm = blend_mode(bm);
+    }
+
+    return *state.bm;
 }
 
 pixel::format cv::pixel_format() const
@@ -55,12 +146,7 @@ pixel::format cv::pixel_format() const
 
 u8 cv::opacity() const
 {
-    Uint8 alpha;
-
-    HAL_ASSERT_VITAL(::SDL_GetTextureAlphaMod(get(), &alpha) == 0,
-        debug::last_error());
-
-    return alpha;
+    return alpha_mod();
 }
 
 void cv::query(Uint32* format, int* access, int* w, int* h) const
@@ -70,38 +156,319 @@ void cv::query(Uint32* format, int* access, int* w, int* h) const
 
 using v = view<texture>;
 
+v::view(SDL_Texture* ptr, pass_key<view<renderer>>)
+    : super { ptr }
+{
+}
+
+v::view(SDL_Texture* ptr, pass_key<command_buffer>)
+    : super { ptr }
+{
+}
+
 void v::opacity(color::value_t value)
 {
-    HAL_ASSERT_VITAL(::SDL_SetTextureAlphaMod(get(), value) == 0, debug::last_error());
+    alpha_mod(value);
 }
 
 void v::alpha_mod(color::value_t val)
 {
-    ::SDL_SetTextureAlphaMod(get(), val);
+    shadow_state& state { state_of(get()) };
+
+    if (elide(state, alpha_mod() == val))
+        return;
+
+    HAL_ASSERT_VITAL(::SDL_SetTextureAlphaMod(get(), val) == 0, debug::last_error());
+
+    state.alpha = val;
 }
 
 void v::color_mod(color clr)
 {
+    shadow_state& state { state_of(get()) };
+
+    const color cur { color_mod() };
+
+    if (elide(state, cur.r == clr.r && cur.g == clr.g && cur.b == clr.b))
+        return;
+
     HAL_ASSERT_VITAL(::SDL_SetTextureColorMod(get(), clr.r, clr.g, clr.b) == 0, debug::last_error());
+
+    state.clr = clr;
 }
 
 void v::blend(blend_mode bm)
 {
+    shadow_state& state { state_of(get()) };
+
+    if (elide(state, blend() == bm))
+        return;
+
     HAL_ASSERT_VITAL(::SDL_SetTextureBlendMode(get(), static_cast<SDL_BlendMode>(bm)) == 0, debug::last_error());
+
+    state.bm = bm;
 }
 
-texture::texture(SDL_Texture* ptr)
+texture::texture(SDL_Texture* ptr, view<const renderer> rnd)
     : raii_object { ptr }
 {
+    // A previous texture might have had the same address.
+    state_of(get()) = shadow_state { rnd.get(), std::nullopt, std::nullopt, std::nullopt };
+
     this->blend(blend_mode::blend);
 }
 
 static_texture::static_texture(view<const renderer> rnd, view<const surface> surf)
-    : texture { ::SDL_CreateTextureFromSurface(rnd.get(), surf.get()) }
+    : texture { ::SDL_CreateTextureFromSurface(rnd.get(), surf.get()), rnd }
 {
+    HAL_PROFILE_COUNT(texture_uploads, 1);
 }
 
 target_texture::target_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size)
-    : texture { ::SDL_CreateTexture(rnd.get(), static_cast<Uint32>(fmt), SDL_TEXTUREACCESS_TARGET, size.x, size.y) }
+    : texture { ::SDL_CreateTexture(rnd.get(), static_cast<Uint32>(fmt), SDL_TEXTUREACCESS_TARGET, size.x, size.y), rnd }
+{
+}
+
+streaming_texture::streaming_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size)
+    : texture { ::SDL_CreateTexture(rnd.get(), static_cast<Uint32>(fmt), SDL_TEXTUREACCESS_STREAMING, size.x, size.y), rnd }
+{
+}
+
+streaming_texture::lock_guard streaming_texture::lock()
+{
+    return { *this, nullptr, pass_key<streaming_texture> {} };
+}
+
+streaming_texture::lock_guard streaming_texture::lock(const pixel::rect& area)
+{
+    return { *this, &area, pass_key<streaming_texture> {} };
+}
+
+void streaming_texture::update(const pixel::rect& area, std::span<const std::byte> pixels, int pitch)
+{
+    HAL_PROFILE_FUNCTION();
+    HAL_PROFILE_COUNT(texture_uploads, 1);
+
+    HAL_ASSERT(area.size.x > 0 && area.size.y > 0, "Updating an empty area");
+    HAL_ASSERT(pixels.size() >= static_cast<std::size_t>((area.size.y - 1) * pitch + area.size.x * bytes_per_pixel(pixel_format())), "Not enough pixels for update area");
+
+    HAL_ASSERT_VITAL(::SDL_UpdateTexture(get(), area.addr(), pixels.data(), pitch) == 0, debug::last_error());
+}
+
+void streaming_texture::update(const pixel::rect& area, std::span<const std::byte> pixels)
+{
+    update(area, pixels, area.size.x * bytes_per_pixel(pixel_format()));
+}
+
+streaming_texture::lock_guard::lock_guard(streaming_texture& tex, const pixel::rect* area, pass_key<streaming_texture>)
+    : m_tex { tex.get() }
+    , m_size { area != nullptr ? area->size : tex.size() }
+    , m_rowBytes { m_size.x * bytes_per_pixel(tex.pixel_format()) }
+{
+    void* pixels;
+
+    HAL_ASSERT_VITAL(::SDL_LockTexture(m_tex, area != nullptr ? area->addr() : nullptr, &pixels, &m_pitch) == 0, debug::last_error());
+
+    m_pixels = static_cast<std::byte*>(pixels);
+}
+
+streaming_texture::lock_guard::~lock_guard()
+{
+    HAL_PROFILE_COUNT(texture_uploads, 1);
+
+    ::SDL_UnlockTexture(m_tex);
+}
+
+std::span<std::byte> streaming_texture::lock_guard::row(pixel_t y) const
+{
+    HAL_ASSERT(y >= 0 && y < m_size.y, "Out-of-range row");
+
+    return { m_pixels + y * m_pitch, static_cast<std::size_t>(m_rowBytes) };
+}
+
+std::span<std::byte> streaming_texture::lock_guard::bytes() const
+{
+    return { m_pixels, static_cast<std::size_t>((m_size.y - 1) * m_pitch + m_rowBytes) };
+}
+
+int streaming_texture::lock_guard::pitch() const
+{
+    return m_pitch;
+}
+
+pixel::point streaming_texture::lock_guard::size() const
+{
+    return m_size;
+}
+
+buffered_texture::buffered_texture(view<const renderer> rnd, pixel::format fmt, pixel::point size)
+    : m_textures { streaming_texture { rnd, fmt, size }, streaming_texture { rnd, fmt, size } }
+    , m_pixels(static_cast<std::size_t>(size.x) * size.y * bytes_per_pixel(fmt))
+    , m_pitch { size.x * bytes_per_pixel(fmt) }
+    , m_size { size }
+    , m_format { fmt }
+{
+    // Neither texture has been written to yet.
+    for (std::vector<pixel::rect>& dirty : m_dirty)
+        dirty.push_back({ 0, 0, size.x, size.y });
+}
+
+void buffered_texture::update(const pixel::rect& area, std::span<const std::byte> pixels, int pitch)
+{
+    // Past this, a single bounding box is cheaper to upload than many small areas.
+    constexpr std::size_t max_dirty { 16 };
+
+    HAL_ASSERT(area.pos.x >= 0 && area.pos.y >= 0 && area.pos.x + area.size.x <= m_size.x && area.pos.y + area.size.y <= m_size.y, "Update area out of bounds");
+
+    const int bpp { bytes_per_pixel(m_format) };
+    const int row_bytes { area.size.x * bpp };
+
+    HAL_ASSERT(pixels.size() >= static_cast<std::size_t>((area.size.y - 1) * pitch + row_bytes), "Not enough pixels for update area");
+
+    for (pixel_t y { 0 }; y < area.size.y; ++y)
+        std::memcpy(m_pixels.data() + (area.pos.y + y) * m_pitch + area.pos.x * bpp, pixels.data() + y * pitch, row_bytes);
+
+    for (std::vector<pixel::rect>& dirty : m_dirty)
+    {
+        dirty.push_back(area);
+
+        if (dirty.size() > max_dirty)
+        {
+            pixel::point lo { m_size }, hi { 0, 0 };
+
+            for (const pixel::rect& r : dirty)
+            {
+                lo = { std::min(lo.x, r.pos.x), std::min(lo.y, r.pos.y) };
+                hi = { std::max(hi.x, r.pos.x + r.size.x), std::max(hi.y, r.pos.y + r.size.y) };
+            }
+
+            dirty.assign(1, { lo.x, lo.y, hi.x - lo.x, hi.y - lo.y });
+        }
+    }
+}
+
+void buffered_texture::update(const pixel::rect& area, std::span<const std::byte> pixels)
+{
+    update(area, pixels, area.size.x * bytes_per_pixel(m_format));
+}
+
+void buffered_texture::swap()
+{
+    HAL_PROFILE_FUNCTION();
+
+    const u8 back { static_cast<u8>(m_front ^ 1) };
+
+    const int bpp { bytes_per_pixel(m_format) };
+
+    for (const pixel::rect& r : m_dirty[back])
+    {
+        const std::size_t offset { static_cast<std::size_t>(r.pos.y * m_pitch + r.pos.x * bpp) };
+
+        m_textures[back].update(r, std::span { m_pixels }.subspan(offset), m_pitch);
+    }
+
+    m_dirty[back].clear();
+
+    m_front = back;
+}
+
+view<const texture> buffered_texture::front() const
+{
+    return m_textures[m_front];
+}
+
+pixel::point buffered_texture::size() const
+{
+    return m_size;
+}
+
+pixel::format buffered_texture::pixel_format() const
+{
+    return m_format;
+}
+
+mip_texture::mip_texture(view<const renderer> rnd, view<const surface> surf, enum filter f)
+    : m_size { surf.size() }
+{
+    HAL_PROFILE_FUNCTION();
+
+    m_levels.emplace_back(rnd, surf);
+
+    // Each level is downscaled from the previous one, which keeps filter footprints small.
+    surface prev;
+
+    for (pixel::point sz { surf.size() }; sz.x > 1 && sz.y > 1;)
+    {
+        sz = { sz.x / 2, sz.y / 2 };
+
+        surface next { (prev.valid() ? view<const surface> { prev } : surf).resize(sz, f) };
+
+        m_levels.emplace_back(rnd, next);
+
+        prev = std::move(next);
+    }
+}
+
+view<const texture> mip_texture::level(std::size_t idx) const
+{
+    HAL_ASSERT(idx < m_levels.size(), "Out-of-range mip level");
+
+    return m_levels[idx];
+}
+
+pixel::point mip_texture::level_size(std::size_t idx) const
+{
+    return { static_cast<pixel_t>(m_size.x >> idx), static_cast<pixel_t>(m_size.y >> idx) };
+}
+
+std::size_t mip_texture::level_for(pixel::point src, coord::point dst) const
+{
+    if (dst.x <= 0 || dst.y <= 0)
+        return 0;
+
+    // Go down as long as the next level still covers the destination.
+    f64 ratio { std::min(src.x / static_cast<f64>(dst.x), src.y / static_cast<f64>(dst.y)) };
+
+    std::size_t ret { 0 };
+
+    while (ret + 1 < m_levels.size() && ratio >= 2.0)
+    {
+        ratio /= 2.0;
+        ++ret;
+    }
+
+    return ret;
+}
+
+std::size_t mip_texture::levels() const
+{
+    return m_levels.size();
+}
+
+pixel::point mip_texture::size() const
+{
+    return m_size;
+}
+
+void mip_texture::opacity(color::value_t value)
+{
+    for (static_texture& tex : m_levels)
+        tex.opacity(value);
+}
+
+void mip_texture::color_mod(color mod)
+{
+    for (static_texture& tex : m_levels)
+        tex.color_mod(mod);
+}
+
+void mip_texture::blend(blend_mode bm)
+{
+    for (static_texture& tex : m_levels)
+        tex.blend(bm);
+}
+
+bool mip_texture::valid() const
 {
+    return !m_levels.empty() && m_levels.front().valid();
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include <halcyon/video/upload_queue.hpp>
+
+#include <halcyon/utility/timer.hpp>
+
+using namespace hal;
+
+upload_queue::upload_queue(view<renderer> rnd)
+    : m_rnd { rnd }
+{
+}
+
+void upload_queue::push(std::future<surface> surf, callback done)
+{
+    HAL_ASSERT(surf.valid(), "Pushing an invalid future");
+
+    m_pending.push_back({ std::move(surf), std::move(done) });
+}
+
+std::size_t upload_queue::process(std::chrono::nanoseconds budget)
+{
+    const timer t;
+
+    const f64 seconds { std::chrono::duration<f64>(budget).count() };
+
+    std::size_t ret { 0 };
+
+    // Surfaces finish decoding in any order, so look through the entire queue (in FIFO order).
+    for (auto it = m_pending.begin(); it != m_pending.end();)
+    {
+        if (ret > 0 && t() >= seconds)
+            break;
+
+        if (it->surf.wait_for(std::chrono::seconds::zero()) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        upload(*it);
+        it = m_pending.erase(it);
+
+        ++ret;
+    }
+
+    return ret;
+}
+
+void upload_queue::finish()
+{
+    for (pending& p : m_pending)
+        upload(p);
+
+    m_pending.clear();
+}
+
+std::size_t upload_queue::size() const
+{
+    return m_pending.size();
+}
+
+bool upload_queue::empty() const
+{
+    return m_pending.empty();
+}
+
+void upload_queue::upload(pending& p)
+{
+    const surface surf { p.surf.get() };
+
+    p.done(m_rnd.make_texture(surf));
+}
\ No newline at end of file
@@ -1,6 +1,17 @@
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+#include <halcyon/archive.hpp>
 #include <halcyon/audio.hpp>
 #include <halcyon/video.hpp>
 
+#include <halcyon/utility/frame_pacer.hpp>
+#include <halcyon/utility/locks.hpp>
+#include <halcyon/utility/output_buffer.hpp>
+#include <halcyon/utility/strutil.hpp>
+#include <halcyon/utility/thread_pool.hpp>
+
 #include "data.hpp"
 
 // Halcyon testing.
@@ -148,6 +159,143 @@ namespace test
         return EXIT_SUCCESS;
     }
 
+    // Batched polling and compile-time dispatch.
+    int event_batch()
+    {
+        hal::context        ctx;
+        hal::system::events evt { ctx };
+
+        using enum hal::event::type;
+
+        // Start with a small batch, so that polling has to grow it.
+        hal::event::batch batch { 2 };
+
+        evt.poll(batch);
+
+        hal::event::holder eh;
+
+        for (int i { 0 }; i < 5; ++i)
+        {
+            eh.kind(text_input);
+            eh.text_input().text("a");
+            evt.push(eh);
+        }
+
+        eh.kind(quit_requested);
+        evt.push(eh);
+
+        const std::size_t polled { evt.poll(batch) };
+
+        HAL_ASSERT(polled == 6, "Unexpected batch size: ", batch.size());
+
+        // Handlers for everything else are skipped at compile time.
+        struct counter
+        {
+            int texts { 0 }, quits { 0 };
+
+            void operator()(hal::event::on<text_input>, const hal::event::text_input& ti)
+            {
+                texts += ti.text() == "a";
+            }
+
+            void operator()(hal::event::on<quit_requested>)
+            {
+                ++quits;
+            }
+        } cnt;
+
+        batch.dispatch(cnt);
+
+        HAL_ASSERT(cnt.texts == 5 && cnt.quits == 1, "Events missed by dispatch");
+
+        const std::size_t remaining { evt.poll(batch) };
+
+        HAL_ASSERT(remaining == 0 && batch.empty(), "Event queue wasn't drained");
+
+        return EXIT_SUCCESS;
+    }
+
+    // Building input snapshots and reading them from another thread.
+    int input_snapshot()
+    {
+        using enum hal::event::type;
+
+        hal::input::tracker trk;
+        hal::event::holder  eh;
+
+        eh.kind(key_pressed);
+        eh.keyboard().button(hal::keyboard::button::W);
+        trk.feed(eh);
+
+        eh.kind(mouse_pressed);
+        eh.mouse_button().button(hal::mouse::button::left).pos({ 10, 20 });
+        trk.feed(eh);
+
+        eh.kind(mouse_moved);
+        eh.mouse_motion().pos({ 15, 25 }).rel({ 5, 5 });
+        trk.feed(eh);
+        trk.feed(eh);
+
+        eh.kind(mouse_wheel_moved);
+        eh.mouse_wheel().scroll_precise({ 0.0f, 1.5f }).scroll_flipped(true);
+        trk.feed(eh);
+
+        trk.publish();
+
+        {
+            const hal::input::snapshot& snap { trk.latest() };
+
+            HAL_ASSERT(snap.frame == 1, "Wrong frame number");
+            HAL_ASSERT(snap[hal::keyboard::button::W] && !snap[hal::keyboard::button::S], "Wrong keyboard state");
+            HAL_ASSERT(snap[hal::mouse::button::left] && !snap[hal::mouse::button::right], "Wrong mouse button state");
+            HAL_ASSERT((snap.pos == hal::pixel::point { 15, 25 } && snap.delta == hal::pixel::point { 10, 10 }), "Wrong mouse position");
+            HAL_ASSERT(snap.wheel.y == -1.5f, "Flipped scrolling wasn't corrected");
+        }
+
+        // Held state carries over, per-frame amounts don't.
+        eh.kind(key_released);
+        eh.keyboard().button(hal::keyboard::button::W);
+        trk.feed(eh);
+        trk.publish();
+
+        {
+            const hal::input::snapshot& snap { trk.latest() };
+
+            HAL_ASSERT(snap.frame == 2 && !snap[hal::keyboard::button::W], "Key release missed");
+            HAL_ASSERT((snap[hal::mouse::button::left] && snap.delta == hal::pixel::point { 0, 0 } && snap.wheel.y == 0.0f), "Per-frame state wasn't reset");
+        }
+
+        // A reader must never see a half-written frame.
+        hal::triple_buffer<std::array<hal::u64, 64>> tb;
+
+        constexpr hal::u64 frames { 100'000 };
+
+        std::jthread writer { [&tb]
+            {
+                for (hal::u64 i { 1 }; i <= frames; ++i)
+                {
+                    tb.back().fill(i);
+                    tb.publish();
+                } } };
+
+        hal::u64 last { 0 };
+
+        while (last < frames)
+        {
+            const std::array<hal::u64, 64>& arr { tb.read() };
+
+            HAL_ASSERT(std::ranges::all_of(arr, [&arr](hal::u64 v)
+                           { return v == arr.front(); }),
+                "Torn read");
+
+            HAL_ASSERT(arr.front() >= last, "Frames went backwards");
+
+            last = arr.front();
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     // Basic TTF initialization.
     int ttf_init()
     {
@@ -162,6 +310,47 @@ namespace test
         return EXIT_SUCCESS;
     }
 
+    // UTF-8 decoding for cached text. Malformed input decodes to U+FFFD, one byte at a time.
+    int utf8()
+    {
+        constexpr char32_t bad { 0xFFFD };
+
+        const auto decode = [](std::string_view str)
+        {
+            std::vector<char32_t> ret;
+
+            while (!str.empty())
+                ret.push_back(hal::pop_codepoint(str));
+
+            return ret;
+        };
+
+        const std::pair<std::string_view, std::vector<char32_t>> cases[] {
+            { "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", { U'A', 0xE9, 0x20AC, 0x1F600 } }, // Valid, 1 to 4 bytes.
+            { "\xF4\x8F\xBF\xBF", { 0x10FFFF } },                                         // Largest code point.
+            { "\xC0\xAF", { bad, bad } },                                                 // Overlong (C0/C1 lead).
+            { "\xE0\x80\xAF", { bad, bad, bad } },                                        // Overlong, 3 bytes.
+            { "\xF0\x80\x80\xAF", { bad, bad, bad, bad } },                               // Overlong, 4 bytes.
+            { "\xED\xA0\x80", { bad, bad, bad } },                                        // UTF-16 surrogate.
+            { "\xF4\x90\x80\x80", { bad, bad, bad, bad } },                               // Past U+10FFFF.
+            { "\xF5\x80\x80\x80", { bad, bad, bad, bad } },                               // Lead past F4.
+            { "\xE2\x82", { bad, bad } },                                                 // Truncated.
+            { "\xE2\x82" "A", { bad, bad, U'A' } },                                       // Interrupted.
+            { "\x80", { bad } }                                                           // Stray continuation byte.
+        };
+
+        for (std::size_t i { 0 }; i < std::size(cases); ++i)
+        {
+            if (decode(cases[i].first) != cases[i].second)
+            {
+                HAL_PRINT("HalTest: UTF-8 decoding mismatch in case #", i);
+                return EXIT_FAILURE;
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     int rvalues()
     {
         hal::context c;
@@ -206,6 +395,239 @@ namespace test
         return EXIT_SUCCESS;
     }
 
+    // Saving into pooled memory buffers, reusing their allocations.
+    int output_buffer()
+    {
+        hal::surface s { { 16, 16 } };
+        s.fill(hal::palette::orange);
+
+        hal::output_buffer::pool pool;
+
+        std::size_t capacity;
+
+        {
+            const hal::output_buffer::pool::lease buf { pool.acquire() };
+
+            s.save(*buf);
+
+            HAL_ASSERT(buf->size() > 2 && std::memcmp(buf->data().data(), "BM", 2) == 0, "Not a BMP");
+
+            const hal::surface loaded { hal::accessor { buf->data() } };
+
+            HAL_ASSERT(loaded.size() == s.size(), "BMP round trip failed");
+
+            capacity = buf->capacity();
+        }
+
+        HAL_ASSERT(pool.available() == 1, "Buffer wasn't returned to the pool");
+
+        {
+            const hal::output_buffer::pool::lease buf { pool.acquire() };
+
+            HAL_ASSERT(pool.available() == 0 && buf->size() == 0, "Reused buffer wasn't cleared");
+
+            s.save(*buf);
+
+            HAL_ASSERT(buf->capacity() == capacity, "Reused buffer reallocated");
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Bulk pixel operations, compared against their per-pixel equivalents.
+    // The odd width makes sure vectorized kernels leave a scalar tail.
+    int surface_kernels()
+    {
+        constexpr hal::pixel::point size { 19, 3 };
+
+        hal::surface s { size, hal::pixel::format::argb32 };
+
+        const auto pattern = [](hal::pixel::point pt) -> hal::color
+        {
+            return { static_cast<hal::u8>(pt.x * 13), static_cast<hal::u8>(pt.y * 70), static_cast<hal::u8>(pt.x * pt.y), static_cast<hal::u8>(255 - pt.x * 10) };
+        };
+
+        const auto reset = [&]()
+        {
+            for (hal::pixel::point i { 0, 0 }; i.y < size.y; ++i.y)
+                for (i.x = 0; i.x < size.x; ++i.x)
+                    s[i].color(pattern(i));
+        };
+
+        const auto check = [&](std::string_view name, auto expected)
+        {
+            for (hal::pixel::point i { 0, 0 }; i.y < size.y; ++i.y)
+            {
+                for (i.x = 0; i.x < size.x; ++i.x)
+                {
+                    const hal::color want { expected(pattern(i)) }, got { s[i].color() };
+
+                    if (want != got)
+                    {
+                        HAL_PRINT("HalTest: ", name, " mismatch at ", i, " (desired ", want, ", actually ", got, ')');
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        reset();
+        s.invert();
+
+        if (!check("Invert", [](hal::color c)
+                { return -c; }))
+            return EXIT_FAILURE;
+
+        reset();
+        s.premultiply();
+
+        if (!check("Premultiply", [](hal::color c)
+                { return hal::color { static_cast<hal::u8>((c.r * c.a + 127) / 255), static_cast<hal::u8>((c.g * c.a + 127) / 255), static_cast<hal::u8>((c.b * c.a + 127) / 255), c.a }; }))
+            return EXIT_FAILURE;
+
+        reset();
+        s.swizzle(hal::channel::b, hal::channel::g, hal::channel::r, hal::channel::a);
+
+        if (!check("Swizzle", [](hal::color c)
+                { return hal::color { c.b, c.g, c.r, c.a }; }))
+            return EXIT_FAILURE;
+
+        reset();
+        s.transform([](hal::color c)
+            { return -c; });
+
+        if (!check("Transform", [](hal::color c)
+                { return -c; }))
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    }
+
+    // Writing pixels through a typed surface view and reading them back.
+    int surface_view()
+    {
+        constexpr hal::pixel::point size { 5, 3 };
+
+        hal::surface s { size, hal::pixel::format::bgra32 };
+
+        const hal::surface_view<hal::pixel::format::bgra32> sv { s };
+
+        static_assert(std::is_same_v<decltype(sv)::pixel_type, hal::pixel::bgra32_t>);
+
+        for (const std::span<hal::pixel::bgra32_t> row : sv.rows())
+            std::ranges::fill(row, hal::pixel::bgra32_t::from(hal::palette::weezer_blue));
+
+        sv[{ 4, 2 }] = hal::pixel::bgra32_t::from(hal::palette::red);
+
+        for (hal::pixel::point i { 0, 0 }; i.y < size.y; ++i.y)
+        {
+            for (i.x = 0; i.x < size.x; ++i.x)
+            {
+                const hal::color want { i == hal::pixel::point { 4, 2 } ? hal::palette::red : hal::palette::weezer_blue };
+
+                if (s[i].color() != want || static_cast<hal::color>(sv[i]) != want)
+                {
+                    HAL_PRINT("HalTest: Surface view mismatch at ", i, " (desired ", want, ", actually ", s[i].color(), ')');
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        if (sv.contiguous() && std::ranges::count(sv.pixels(), hal::color::value_t { 0xD3 }, &hal::pixel::bgra32_t::b) != size.x * size.y - 1)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    }
+
+    // Resampling a flat surface with every filter must keep its color and hit the desired size.
+    int resample()
+    {
+        hal::surface s { { 8, 8 } };
+        s.fill(hal::palette::weezer_blue);
+
+        hal::thread_pool pool { 2 };
+
+        const auto check = [](const hal::surface& r, hal::pixel::point want)
+        {
+            if (r.size() != want)
+            {
+                HAL_PRINT("HalTest: Resampled size mismatch (desired ", want, ", actually ", r.size(), ')');
+                return false;
+            }
+
+            for (hal::pixel::point i { 0, 0 }; i.y < want.y; ++i.y)
+            {
+                for (i.x = 0; i.x < want.x; ++i.x)
+                {
+                    if (r[i].color() != hal::palette::weezer_blue)
+                    {
+                        HAL_PRINT("HalTest: Resampled color mismatch at ", i, " (actually ", r[i].color(), ')');
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        for (const hal::filter f : { hal::filter::nearest, hal::filter::box, hal::filter::bilinear, hal::filter::bicubic, hal::filter::lanczos3 })
+        {
+            if (!check(s.resize({ 3, 5 }, f), { 3, 5 }) || !check(s.resize({ 3, 5 }, f, pool), { 3, 5 }) || !check(s.resize(hal::scale::mul(2.5f).filter(f)), { 20, 20 }))
+                return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Nearest-neighbour resizing must not depend on whether a thread pool is used,
+    // and must copy translucent pixels as they are.
+    int pooled_resize()
+    {
+        hal::surface s { { 7, 5 } };
+
+        for (hal::pixel::point i { 0, 0 }; i.y < s.size().y; ++i.y)
+            for (i.x = 0; i.x < s.size().x; ++i.x)
+                s[i].color(hal::color { static_cast<hal::u8>(i.x * 36), static_cast<hal::u8>(i.y * 60), 200, static_cast<hal::u8>(32 + i.x * 30) });
+
+        hal::thread_pool pool { 3 };
+
+        for (const hal::pixel::point sz : { hal::pixel::point { 3, 2 }, hal::pixel::point { 16, 11 }, hal::pixel::point { 7, 5 } })
+        {
+            const hal::surface single { s.resize(sz) }, pooled { s.resize(sz, pool) };
+
+            for (hal::pixel::point i { 0, 0 }; i.y < sz.y; ++i.y)
+            {
+                for (i.x = 0; i.x < sz.x; ++i.x)
+                {
+                    if (single[i].color() != pooled[i].color())
+                    {
+                        HAL_PRINT("HalTest: Pooled resize mismatch at ", i, " (desired ", single[i].color(), ", actually ", pooled[i].color(), ')');
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+
+        // Same size: every pixel, including its alpha, comes through unchanged.
+        const hal::surface same { s.resize(s.size()) };
+
+        for (hal::pixel::point i { 0, 0 }; i.y < s.size().y; ++i.y)
+        {
+            for (i.x = 0; i.x < s.size().x; ++i.x)
+            {
+                if (same[i].color() != s[i].color())
+                {
+                    HAL_PRINT("HalTest: Resized pixel was blended at ", i, " (desired ", s[i].color(), ", actually ", same[i].color(), ')');
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     int png_check()
     {
         hal::image::context ictx { hal::image::init_format::png };
@@ -219,6 +641,117 @@ namespace test
         return EXIT_SUCCESS;
     }
 
+    // Packing entries into an archive and loading them back.
+    int archive()
+    {
+        const std::string path { (std::filesystem::temp_directory_path() / "haltest.hla").string() };
+
+        {
+            hal::archive::writer wrt;
+
+            wrt.add("images/red_blue.png", hal::as_bytes(png_2x1));
+
+            for (int i { 0 }; i < 100; ++i)
+                wrt.add(hal::string_from_pack("filler_", i), hal::as_bytes(png_2x1));
+
+            wrt.save(hal::outputter { path });
+        }
+
+        const hal::archive arc { path };
+
+        HAL_ASSERT(arc.size() == 101, "Wrong entry count: ", arc.size());
+        HAL_ASSERT(arc.contains("filler_99") && !arc.contains("filler_100"), "Wrong lookup result");
+
+        hal::image::context ictx { hal::image::init_format::png };
+
+        hal::surface s { ictx.load(arc.open("images/red_blue.png")) };
+
+        HAL_ASSERT((s[{ 0, 0 }].color() == hal::palette::red && s[{ 1, 0 }].color() == hal::palette::blue), "Archived image corrupted");
+
+        std::filesystem::remove(path);
+
+        return EXIT_SUCCESS;
+    }
+
+    // Loading and saving through user-provided streams.
+    int streams()
+    {
+        // Hands out a few bytes at a time and can't seek, like a decompressor would.
+        struct trickle
+        {
+            std::span<const std::byte> data;
+
+            std::size_t read(std::span<std::byte> buf)
+            {
+                const std::size_t amount { std::min({ buf.size(), data.size(), std::size_t { 3 } }) };
+
+                std::memcpy(buf.data(), data.data(), amount);
+                data = data.subspan(amount);
+
+                return amount;
+            }
+        };
+
+        hal::image::context ictx { hal::image::init_format::png };
+
+        // Format detection seeks back within the read-ahead buffer.
+        hal::surface s { ictx.load(trickle { hal::as_bytes(png_2x1) }) };
+
+        HAL_ASSERT((s[{ 0, 0 }].color() == hal::palette::red && s[{ 1, 0 }].color() == hal::palette::blue), "Streamed image corrupted");
+
+        // BMP saving seeks back to fill in the header.
+        std::stringstream str;
+        s.save(str);
+
+        HAL_ASSERT(str.str().starts_with("BM"), "Not a BMP");
+
+        const hal::surface bmp { hal::accessor { str } };
+
+        HAL_ASSERT(bmp.size() == s.size(), "BMP round trip failed");
+
+        return EXIT_SUCCESS;
+    }
+
+    // Decoding a batch of images on a thread pool and uploading them within a budget.
+    int async_load()
+    {
+        constexpr std::size_t count { 16 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Async load", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::image::context ictx { hal::image::init_format::png };
+        hal::thread_pool    pool { 2 };
+
+        std::vector<hal::accessor> sources;
+
+        for (std::size_t i { 0 }; i < count; ++i)
+            sources.emplace_back(hal::as_bytes(png_2x1));
+
+        hal::upload_queue queue { rnd };
+
+        std::size_t uploaded { 0 };
+
+        for (std::future<hal::surface>& surf : ictx.load(std::move(sources), pool))
+        {
+            queue.push(std::move(surf), [&](hal::static_texture tex)
+                {
+                    HAL_ASSERT((tex.size() == hal::pixel::point { 2, 1 }), "Decoded texture size mismatch");
+                    ++uploaded;
+                });
+        }
+
+        while (!queue.empty())
+            queue.process(std::chrono::milliseconds { 1 });
+
+        HAL_ASSERT(uploaded == count, "Upload count mismatch");
+
+        return EXIT_SUCCESS;
+    }
+
     int views()
     {
         hal::context       ctx;
@@ -279,6 +812,358 @@ namespace test
         return EXIT_SUCCESS;
     }
 
+    // Packing surfaces of various sizes into an atlas and checking for overlaps.
+    int atlas()
+    {
+        constexpr hal::pixel::point page_size { 256, 256 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Atlas", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        std::vector<hal::surface> surfaces;
+
+        for (hal::pixel_t i { 0 }; i < 64; ++i)
+            surfaces.emplace_back(hal::pixel::point { 8 + i * 7 % 40, 8 + i * 13 % 56 });
+
+        hal::atlas_builder builder { page_size };
+
+        for (const hal::surface& s : surfaces)
+            builder.add(s);
+
+        const hal::atlas atl { builder(rnd) };
+
+        HAL_ASSERT(atl.size() == surfaces.size(), "Atlas entry count mismatch");
+
+        for (hal::atlas::id_t i { 0 }; i < atl.size(); ++i)
+        {
+            const hal::atlas::entry& e { atl[i] };
+
+            HAL_ASSERT(e.page < atl.pages(), "Atlas page index out of range");
+            HAL_ASSERT(e.area.size == surfaces[i].size(), "Atlas entry size mismatch");
+            HAL_ASSERT(e.area.pos.x >= 0 && e.area.pos.y >= 0 && e.area.pos.x + e.area.size.x <= page_size.x && e.area.pos.y + e.area.size.y <= page_size.y,
+                "Atlas entry out of page bounds");
+
+            for (hal::atlas::id_t j { i + 1 }; j < atl.size(); ++j)
+            {
+                const hal::atlas::entry& o { atl[j] };
+
+                const bool overlap { e.page == o.page
+                    && e.area.pos.x < o.area.pos.x + o.area.size.x && o.area.pos.x < e.area.pos.x + e.area.size.x
+                    && e.area.pos.y < o.area.pos.y + o.area.size.y && o.area.pos.y < e.area.pos.y + e.area.size.y };
+
+                HAL_ASSERT(!overlap, "Atlas entries ", i, " and ", j, " overlap");
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // Mip chain sizes and level selection.
+    int mipmaps()
+    {
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Mipmaps", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::surface s { { 64, 16 } };
+        s.fill(hal::palette::orange);
+
+        const hal::mip_texture tex { rnd.make_texture(s, hal::tag::mipmapped) };
+
+        HAL_ASSERT(tex.levels() == 5, "Mip level count mismatch");
+
+        for (std::size_t i { 0 }; i < tex.levels(); ++i)
+            HAL_ASSERT(tex.level(i).size() == tex.level_size(i), "Mip level ", i, " size mismatch");
+
+        HAL_ASSERT(tex.level_for(tex.size(), { 64, 16 }) == 0, "Full-size draws must use the full-size level");
+        HAL_ASSERT(tex.level_for(tex.size(), { 40, 10 }) == 0, "Levels must not be smaller than the destination");
+        HAL_ASSERT(tex.level_for(tex.size(), { 16, 4 }) == 2, "Quarter-size draws must use the quarter-size level");
+        HAL_ASSERT(tex.level_for(tex.size(), { 1, 1 }) == tex.levels() - 1, "Tiny draws must use the smallest level");
+
+        rnd.render(tex).to(hal::coord::rect { 10, 10, 16, 4 })();
+
+        return EXIT_SUCCESS;
+    }
+
+    // Recording command buffers on several threads and replaying them on the render thread.
+    int command_buffer()
+    {
+        constexpr std::size_t parts { 4 }, rects { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Command buffer", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::surface surf { { 16, 16 } };
+        surf.fill(hal::palette::orange);
+
+        const hal::static_texture tex { rnd.make_texture(surf) };
+
+        std::vector<hal::command_buffer> buffers(parts);
+
+        {
+            std::vector<std::jthread> threads;
+
+            for (std::size_t p { 0 }; p < parts; ++p)
+            {
+                threads.emplace_back([&, p]()
+                    {
+                        hal::command_buffer& buf { buffers[p] };
+
+                        buf.color(hal::palette::weezer_blue);
+                        buf.blend(hal::blend_mode::none);
+
+                        for (std::size_t i { 0 }; i < rects; ++i)
+                            buf.fill(hal::coord::rect { static_cast<hal::coord_t>(i), static_cast<hal::coord_t>(p * 100), 10.0f, 10.0f });
+
+                        buf.draw(hal::coord::point { 0.0f, 0.0f }, hal::coord::point { 100.0f, 100.0f });
+                        buf.render(tex).to(hal::coord::point { 50.0f, 50.0f }).rotate(45.0)();
+                    });
+            }
+        }
+
+        for (const hal::command_buffer& buf : buffers)
+        {
+            HAL_ASSERT(buf.size() == rects + 4, "Recorded command count mismatch");
+
+            buf.replay(rnd);
+        }
+
+        rnd.present();
+
+        buffers.front().reset();
+
+        HAL_ASSERT(buffers.front().empty(), "Reset command buffer isn't empty");
+
+        return EXIT_SUCCESS;
+    }
+
+    // Redundant state changes must be skipped and counted.
+    int state_cache()
+    {
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: State cache", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::target_texture tgt { rnd.make_target_texture({ 32, 32 }) };
+
+        rnd.color(hal::palette::red);
+        rnd.color(hal::palette::red);
+        rnd.blend(hal::blend_mode::add);
+        rnd.blend(hal::blend_mode::add);
+
+        {
+            hal::lock::color _ { rnd, hal::palette::red };
+        }
+
+        rnd.target(tgt);
+        rnd.target(tgt);
+
+        HAL_ASSERT(rnd.target().get() == tgt.get(), "Cached render target mismatch");
+
+        rnd.reset_target();
+
+        HAL_ASSERT(!rnd.target().valid(), "Render target wasn't reset");
+        HAL_ASSERT(rnd.color() == hal::palette::red, "Cached draw color mismatch");
+
+        tgt.opacity(128);
+        tgt.opacity(128);
+
+        rnd.present();
+
+        const hal::elided_calls calls { rnd.elided_calls() };
+
+        HAL_ASSERT(calls.color == 3 && calls.blend == 1 && calls.target == 1 && calls.texture_mods == 1, "Unexpected elided call counts");
+
+        return EXIT_SUCCESS;
+    }
+
+    // Interleaved sprites from two textures merge into two draw calls, unless their layer is ordered.
+    // Presenting draws whatever is still queued.
+    int render_queue()
+    {
+        constexpr std::size_t sprites { 100 };
+
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Render queue", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::surface surf { { 8, 8 } };
+        surf.fill(hal::palette::orange);
+
+        const hal::static_texture a { rnd.make_texture(surf) }, b { rnd.make_texture(surf) };
+
+        hal::render_queue queue { rnd.make_render_queue() };
+
+        const auto fill = [&](hal::u8 layer)
+        {
+            for (std::size_t i { 0 }; i < sprites; ++i)
+                queue.draw(i % 2 == 0 ? a : b).to(hal::coord::point { static_cast<hal::coord_t>(i), 0.0f }).layer(layer).depth(static_cast<hal::u16>(sprites - i))();
+        };
+
+        fill(0);
+        queue.flush();
+
+        HAL_ASSERT(queue.draw_calls() == 2, "Sorted sprites weren't merged (", queue.draw_calls(), " draw calls)");
+
+        queue.ordered(1, true);
+
+        fill(1);
+        queue.flush();
+
+        HAL_ASSERT(queue.draw_calls() == sprites, "Ordered layer was reordered (", queue.draw_calls(), " draw calls)");
+        HAL_ASSERT(queue.size() == 0, "Flushed queue isn't empty");
+
+        // Presenting flushes the queue.
+        fill(0);
+        rnd.present();
+
+        HAL_ASSERT(queue.size() == 0 && queue.draw_calls() == 2, "Presenting didn't flush the queue");
+
+        return EXIT_SUCCESS;
+    }
+
+    // Span-based primitives (including empty spans) and the primitive batch.
+    int primitives()
+    {
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Primitives", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        const hal::coord::point pts[] { { 0.0f, 0.0f }, { 10.0f, 5.0f }, { 20.0f, 0.0f } };
+        const hal::coord::rect  rects[] { { 0.0f, 0.0f, 4.0f, 4.0f }, { 8.0f, 8.0f, 4.0f, 4.0f } };
+
+        rnd.draw_points(pts);
+        rnd.draw_lines(pts);
+        rnd.draw_rects(rects);
+        rnd.fill(rects);
+
+        rnd.draw_points({});
+        rnd.draw_lines({});
+        rnd.draw_rects({});
+        rnd.fill(std::span<const hal::coord::rect> {});
+
+        hal::primitive_batch batch { rnd.make_primitive_batch() };
+
+        batch.point({ 1.0f, 1.0f }, hal::palette::red);
+        batch.line({ 0.0f, 0.0f }, { 100.0f, 50.0f }, hal::palette::green);
+        batch.line({ 5.0f, 5.0f }, { 5.0f, 5.0f }, hal::palette::green);
+        batch.outline({ 10.0f, 10.0f, 20.0f, 20.0f }, hal::palette::blue);
+        batch.fill({ 40.0f, 40.0f, 20.0f, 20.0f }, hal::palette::weezer_blue);
+
+        HAL_ASSERT(batch.size() == 8, "Unexpected primitive quad count: ", batch.size());
+
+        batch.flush();
+
+        HAL_ASSERT(batch.size() == 0, "Flushed primitive batch isn't empty");
+
+        rnd.present();
+
+        return EXIT_SUCCESS;
+    }
+
+    // Indexed and non-indexed meshes, with and without a texture, updated in place.
+    int mesh()
+    {
+        hal::context       ctx;
+        hal::system::video vid { ctx };
+
+        hal::window   wnd { vid.make_window("HalTest: Mesh", { 640, 480 }, { hal::window::flags::hidden }) };
+        hal::renderer rnd { wnd.make_renderer() };
+
+        hal::surface surf { { 8, 8 } };
+        surf.fill(hal::palette::orange);
+
+        const hal::static_texture tex { rnd.make_texture(surf) };
+
+        hal::mesh quad;
+
+        const hal::mesh::index_t tl { quad.push({ 10.0f, 10.0f }, hal::palette::white, { 0.0f, 0.0f }) },
+            tr { quad.push({ 90.0f, 10.0f }, hal::palette::red, { 1.0f, 0.0f }) },
+            br { quad.push({ 90.0f, 90.0f }, hal::palette::green, { 1.0f, 1.0f }) },
+            bl { quad.push({ 10.0f, 90.0f }, hal::palette::blue, { 0.0f, 1.0f }) };
+
+        quad.push(tl, tr, br, bl);
+
+        HAL_ASSERT(quad.size() == 4 && quad.indices().size() == 6, "Unexpected mesh size");
+
+        rnd.draw(quad);
+        rnd.draw(quad, tex);
+
+        // Partial update: move the mesh without touching colors or UVs.
+        for (hal::coord::point& pt : quad.positions())
+            pt += { 100.0f, 0.0f };
+
+        HAL_ASSERT(quad.colors()[1] == hal::palette::red, "Mesh colors changed by a position update");
+
+        rnd.draw(quad, tex);
+
+        hal::mesh tris { 3 };
+        tris.positions()[1] = { 50.0f, 0.0f };
+        tris.positions()[2] = { 0.0f, 50.0f };
+
+        rnd.draw(tris);
+        rnd.draw(hal::mesh {});
+
+        rnd.present();
+
+        return EXIT_SUCCESS;
+    }
+
+    // Frame rate limiting, fixed steps and the frame time histogram.
+    int frame_pacer()
+    {
+        using namespace std::chrono_literals;
+
+        hal::frame_histogram hist { 1ms, 10 };
+
+        for (const auto t : { 500us, 1500us, 1500us, 2500us, 50000us })
+            hist.add(t);
+
+        HAL_ASSERT(hist.count() == 5 && hist.buckets()[1] == 2 && hist.buckets().back() == 1, "Unexpected histogram buckets");
+        HAL_ASSERT(hist.percentile(0.5) == 2ms && hist.percentile(1.0) == 50ms, "Unexpected histogram percentiles");
+        HAL_ASSERT(hist.min() == 500us && hist.max() == 50ms, "Unexpected histogram extremes");
+
+        constexpr int frames { 20 };
+
+        hal::frame_pacer pacer { 200.0 };
+        pacer.step_size(1.0 / 400.0);
+
+        const hal::timer tmr;
+
+        int steps { 0 };
+
+        for (int i { 0 }; i < frames; ++i)
+        {
+            pacer.tick();
+
+            while (pacer.step())
+                ++steps;
+
+            HAL_ASSERT(pacer.alpha() >= 0.0 && pacer.alpha() < 1.0, "Interpolation factor out of range");
+        }
+
+        // Frames can run late, but never early.
+        HAL_ASSERT(tmr() >= frames / 200.0 * 0.99, "Frame pacer ran too fast: ", tmr(), 's');
+        HAL_ASSERT(pacer.histogram().count() == frames, "Missing frame times");
+        HAL_ASSERT(steps >= frames, "Too few fixed steps: ", steps);
+
+        return EXIT_SUCCESS;
+    }
+
     // Passing a zeroed-out buffer to a function expecting valid image data.
     // This test should fail.
     int invalid_buffer()
@@ -336,14 +1221,33 @@ int main(int argc, char* argv[])
         { "--clipboard", test::clipboard },
         { "--surface-color", test::surface_color },
         { "--events", test::events },
+        { "--event-batch", test::event_batch },
+        { "--input-snapshot", test::input_snapshot },
         { "--ttf-init", test::ttf_init },
+        { "--utf8", test::utf8 },
         { "--rvalues", test::rvalues },
         { "--scaler", test::scaler },
         { "--outputter", test::outputter },
+        { "--output-buffer", test::output_buffer },
+        { "--surface-kernels", test::surface_kernels },
+        { "--surface-view", test::surface_view },
+        { "--resample", test::resample },
+        { "--pooled-resize", test::pooled_resize },
         { "--png-check", test::png_check },
+        { "--archive", test::archive },
+        { "--streams", test::streams },
+        { "--async-load", test::async_load },
         { "--views", test::views },
         { "--metaprogramming", test::metaprogramming },
         { "--audio-init", test::audio_init },
+        { "--atlas", test::atlas },
+        { "--mipmaps", test::mipmaps },
+        { "--command-buffer", test::command_buffer },
+        { "--state-cache", test::state_cache },
+        { "--render-queue", test::render_queue },
+        { "--primitives", test::primitives },
+        { "--mesh", test::mesh },
+        { "--frame-pacer", test::frame_pacer },
         { "--invalid-buffer", test::invalid_buffer },
         { "--invalid-texture", test::invalid_texture },
         { "--invalid-event", test::invalid_event }